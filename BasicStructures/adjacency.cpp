@@ -0,0 +1,197 @@
+#include "adjacency.h"
+
+/**
+ * @brief Adjacency::Adjacency : Construct an empty adjacency
+ */
+Adjacency::Adjacency()
+{
+    neighbourOffsets.push_back(0);
+    faceOffsets.push_back(0);
+}
+
+/**
+ * @brief Adjacency::build: Computes the adjacency of a triangular mesh
+ * @param triangles: flat array with the 3 vertex indexes of every face
+ * @param numFaces: number of faces in triangles
+ * @param numVertexes: number of vertexes of the mesh
+ */
+void Adjacency::build(const int * triangles, int numFaces, int numVertexes)
+{
+    // Count the faces of every vertex, ignoring indexes out of the mesh
+    faceOffsets.assign(numVertexes + 1, 0);
+    for (int i = 0; i < numFaces * 3; i++)
+    {
+        int vertex = triangles[i];
+        if (vertex >= 0 && vertex < numVertexes)
+        {
+            faceOffsets[vertex + 1]++;
+        }
+    }
+    for (int i = 0; i < numVertexes; i++)
+    {
+        faceOffsets[i + 1] += faceOffsets[i];
+    }
+
+    // Fill the faces of every vertex. Faces are visited in increasing order,
+    // so every list is already sorted. A face that repeats a vertex is stored
+    // only once for it.
+    vector<int> position(faceOffsets.begin(), faceOffsets.end() - 1);
+    faces.assign(faceOffsets[numVertexes], 0);
+    for (int iFace = 0; iFace < numFaces; iFace++)
+    {
+        for (int j = 0; j < 3; j++)
+        {
+            int vertex = triangles[3 * iFace + j];
+            if (vertex < 0 || vertex >= numVertexes)
+            {
+                continue;
+            }
+            if (position[vertex] > faceOffsets[vertex] && faces[position[vertex] - 1] == iFace)
+            {
+                continue;
+            }
+            faces[position[vertex]++] = iFace;
+        }
+    }
+
+    // Every face of a vertex contributes at most two neighbours: gather them,
+    // then sort and remove duplicates vertex by vertex while compacting.
+    neighbourOffsets.assign(numVertexes + 1, 0);
+    neighbours.clear();
+    neighbours.reserve(faceOffsets[numVertexes] * 2);
+    for (int vertex = 0; vertex < numVertexes; vertex++)
+    {
+        int begin = neighbours.size();
+        for (int i = faceOffsets[vertex]; i < position[vertex]; i++)
+        {
+            const int * face = triangles + 3 * faces[i];
+            for (int j = 0; j < 3; j++)
+            {
+                if (face[j] != vertex && face[j] >= 0 && face[j] < numVertexes)
+                {
+                    neighbours.push_back(face[j]);
+                }
+            }
+        }
+        sort(neighbours.begin() + begin, neighbours.end());
+        neighbours.erase(unique(neighbours.begin() + begin, neighbours.end()), neighbours.end());
+        neighbourOffsets[vertex + 1] = neighbours.size();
+    }
+
+    // Remove the gaps left by repeated vertexes inside a face
+    int written = 0;
+    for (int vertex = 0; vertex < numVertexes; vertex++)
+    {
+        int begin = faceOffsets[vertex];
+        faceOffsets[vertex] = written;
+        for (int i = begin; i < position[vertex]; i++)
+        {
+            faces[written++] = faces[i];
+        }
+    }
+    faceOffsets[numVertexes] = written;
+    faces.resize(written);
+}
+
+/**
+ * @brief Adjacency::getNumVertexes
+ * @return the number of vertexes described by the adjacency
+ */
+int Adjacency::getNumVertexes() const
+{
+    return neighbourOffsets.size() - 1;
+}
+
+/**
+ * @brief Adjacency::getNumNeighbours
+ * @param vertex: index of the vertex
+ * @return the number of direct neighbours of the vertex
+ */
+int Adjacency::getNumNeighbours(int vertex) const
+{
+    return neighbourOffsets[vertex + 1] - neighbourOffsets[vertex];
+}
+
+/**
+ * @brief Adjacency::getNeighbours
+ * @param vertex: index of the vertex
+ * @return a pointer to the sorted indexes of the direct neighbours of the vertex
+ */
+const int * Adjacency::getNeighbours(int vertex) const
+{
+    return neighbours.data() + neighbourOffsets[vertex];
+}
+
+/**
+ * @brief Adjacency::getNumFaces
+ * @param vertex: index of the vertex
+ * @return the number of faces that contain the vertex
+ */
+int Adjacency::getNumFaces(int vertex) const
+{
+    return faceOffsets[vertex + 1] - faceOffsets[vertex];
+}
+
+/**
+ * @brief Adjacency::getFaces
+ * @param vertex: index of the vertex
+ * @return a pointer to the sorted indexes of the faces that contain the vertex
+ */
+const int * Adjacency::getFaces(int vertex) const
+{
+    return faces.data() + faceOffsets[vertex];
+}
+
+/**
+ * @brief Adjacency::setData: Replaces the adjacency with one computed before,
+ *  e.g. read from a file. The arrays are swapped with the ones of the
+ *  adjacency, so no copy is made.
+ * @param newNeighbourOffsets: offsets of the neighbours of every vertex, plus the total
+ * @param newNeighbours: sorted direct neighbours of all the vertexes
+ * @param newFaceOffsets: offsets of the faces of every vertex, plus the total
+ * @param newFaces: sorted faces that contain each vertex
+ */
+void Adjacency::setData(vector<int> & newNeighbourOffsets, vector<int> & newNeighbours,
+                        vector<int> & newFaceOffsets, vector<int> & newFaces)
+{
+    neighbourOffsets.swap(newNeighbourOffsets);
+    neighbours.swap(newNeighbours);
+    faceOffsets.swap(newFaceOffsets);
+    faces.swap(newFaces);
+}
+
+/**
+ * @brief Adjacency::getNeighbourOffsets
+ * @return the offsets of the neighbours of every vertex, plus the total
+ */
+const vector<int> & Adjacency::getNeighbourOffsets() const
+{
+    return neighbourOffsets;
+}
+
+/**
+ * @brief Adjacency::getAllNeighbours
+ * @return the flat array with the direct neighbours of all the vertexes
+ */
+const vector<int> & Adjacency::getAllNeighbours() const
+{
+    return neighbours;
+}
+
+/**
+ * @brief Adjacency::getFaceOffsets
+ * @return the offsets of the faces of every vertex, plus the total
+ */
+const vector<int> & Adjacency::getFaceOffsets() const
+{
+    return faceOffsets;
+}
+
+/**
+ * @brief Adjacency::getAllFaces
+ * @return the flat array with the faces that contain each vertex
+ */
+const vector<int> & Adjacency::getAllFaces() const
+{
+    return faces;
+}
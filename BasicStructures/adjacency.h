@@ -0,0 +1,126 @@
+#ifndef ADJACENCY_H
+#define ADJACENCY_H
+
+#include <algorithm>
+#include <vector>
+
+using std::vector;
+
+/**
+ * @brief The Adjacency class stores the vertex-to-vertex and vertex-to-face
+ *  adjacency of a triangular mesh in compressed sparse row (CSR) format: for
+ *  every vertex an offset into a flat array of indexes. The neighbours and the
+ *  faces of every vertex are sorted in increasing order.
+ */
+class Adjacency
+{
+    private:
+        /**
+         * @brief neighbourOffsets: neighbours of vertex i are stored in
+         *  neighbours[neighbourOffsets[i]] .. neighbours[neighbourOffsets[i+1]-1]
+         */
+        vector<int> neighbourOffsets;
+
+        /**
+         * @brief neighbours: flat array with the direct neighbours of all the vertexes
+         */
+        vector<int> neighbours;
+
+        /**
+         * @brief faceOffsets: faces of vertex i are stored in
+         *  faces[faceOffsets[i]] .. faces[faceOffsets[i+1]-1]
+         */
+        vector<int> faceOffsets;
+
+        /**
+         * @brief faces: flat array with the faces that contain each vertex
+         */
+        vector<int> faces;
+
+    public:
+
+        /**
+         * @brief Adjacency : Construct an empty adjacency
+         */
+        Adjacency();
+
+        /**
+         * @brief build: Computes the adjacency of a triangular mesh
+         * @param triangles: flat array with the 3 vertex indexes of every face
+         * @param numFaces: number of faces in triangles
+         * @param numVertexes: number of vertexes of the mesh
+         */
+        void build(const int * triangles, int numFaces, int numVertexes);
+
+        /**
+         * @brief setData: Replaces the adjacency with one computed before, e.g.
+         *  read from a file. The arrays are swapped with the ones of the
+         *  adjacency, so no copy is made.
+         * @param newNeighbourOffsets: offsets of the neighbours of every vertex, plus the total
+         * @param newNeighbours: sorted direct neighbours of all the vertexes
+         * @param newFaceOffsets: offsets of the faces of every vertex, plus the total
+         * @param newFaces: sorted faces that contain each vertex
+         */
+        void setData(vector<int> & newNeighbourOffsets, vector<int> & newNeighbours,
+                     vector<int> & newFaceOffsets, vector<int> & newFaces);
+
+        /**
+         * @brief getNeighbourOffsets
+         * @return the offsets of the neighbours of every vertex, plus the total
+         */
+        const vector<int> & getNeighbourOffsets() const;
+
+        /**
+         * @brief getAllNeighbours
+         * @return the flat array with the direct neighbours of all the vertexes
+         */
+        const vector<int> & getAllNeighbours() const;
+
+        /**
+         * @brief getFaceOffsets
+         * @return the offsets of the faces of every vertex, plus the total
+         */
+        const vector<int> & getFaceOffsets() const;
+
+        /**
+         * @brief getAllFaces
+         * @return the flat array with the faces that contain each vertex
+         */
+        const vector<int> & getAllFaces() const;
+
+        /**
+         * @brief getNumVertexes
+         * @return the number of vertexes described by the adjacency
+         */
+        int getNumVertexes() const;
+
+        /**
+         * @brief getNumNeighbours
+         * @param vertex: index of the vertex
+         * @return the number of direct neighbours of the vertex
+         */
+        int getNumNeighbours(int vertex) const;
+
+        /**
+         * @brief getNeighbours
+         * @param vertex: index of the vertex
+         * @return a pointer to the sorted indexes of the direct neighbours of the vertex
+         */
+        const int * getNeighbours(int vertex) const;
+
+        /**
+         * @brief getNumFaces
+         * @param vertex: index of the vertex
+         * @return the number of faces that contain the vertex
+         */
+        int getNumFaces(int vertex) const;
+
+        /**
+         * @brief getFaces
+         * @param vertex: index of the vertex
+         * @return a pointer to the sorted indexes of the faces that contain the vertex
+         */
+        const int * getFaces(int vertex) const;
+};
+
+#endif // ADJACENCY_H
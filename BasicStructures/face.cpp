@@ -1,24 +1,18 @@
 #include "face.h"
+#include "mesh.h"
 
 /**
  * @brief Face::Face
  *  This method construct a Face class without defining its private objects
  */
- 
+
 Face::Face()
 {
     faceIndex = 0 ;
-    pointsInFace = new (nothrow) int[3];
-    if (pointsInFace == nullptr)
-    {
-        cout << "Error: memory could not be allocated";
-    }
-    else
+    pointsInFace = storage;
+    for (int i=0; i<3; i++)
     {
-        for (int i=0; i<3; i++)
-        {
-           *(this->pointsInFace +i ) = 0;
-        }
+       *(this->pointsInFace +i ) = 0;
     }
 }
 
@@ -26,32 +20,56 @@ Face::Face()
  * @brief Face::Face
  * This method construct a Face class defining the following objects
  * @param newIndex :  The index of the created Face
- * @param newCoordinates :  The Face indexes coordinates of the Face
+ * @param newCoordinates :  The Face indexes coordinates of the Face, which are copied
  */
 Face::Face(int newIndex, int* newPoints)
 {
     faceIndex = newIndex ;
-    pointsInFace = new (nothrow) int[3];
-    if (pointsInFace == nullptr)
-    {
-        cout << "Error: memory could not be allocated";
-    }
-    else
+    pointsInFace = storage;
+    for (int i=0; i<3; i++)
     {
-        for (int i=0; i<3; i++)
-        {
-           *(pointsInFace +i ) = *(newPoints + i);
-        }
+       *(pointsInFace +i ) = *(newPoints + i);
     }
 }
 
 /**
- * @brief Face::~Face
- * This method is the destructor of a Face Class
+ * @brief Face::Face
+ * This method construct a view of a face stored in a mesh
+ * @param owner :  The mesh that stores the face
+ * @param newIndex :  The index of the face in the mesh
+ */
+Face::Face(Mesh * owner, int newIndex)
+{
+    faceIndex = newIndex;
+    pointsInFace = owner->getTriangles() + 3 * newIndex;
+}
+
+/**
+ * @brief Face::Face
+ * Copy constructor. The copy of a face of a mesh views the same face.
+ * @param other : The face to copy
+ */
+Face::Face(const Face & other)
+{
+    *this = other;
+}
+
+/**
+ * @brief Face::operator =
+ * Assignment operator. After it, this views the same face as other.
+ * @param other : The face to copy
+ * @return this face
  */
-Face::~Face()
+Face & Face::operator=(const Face & other)
 {
-    delete[] this->pointsInFace;
+    faceIndex = other.faceIndex;
+    for (int i=0; i<3; i++)
+    {
+        storage[i] = other.storage[i];
+    }
+    // A face without mesh must point to its own copy of the indexes
+    pointsInFace = (other.pointsInFace == other.storage)? storage : other.pointsInFace;
+    return *this;
 }
 
 /**
@@ -7,6 +7,14 @@
 using std::cout;
 using std::nothrow;
 
+class Mesh;
+
+/**
+ * @brief The Face class is a lightweight view of a triangular face. A face
+ *  returned by a Mesh reads and writes the indexes stored in the mesh, and stays
+ *  valid until faces are added to that mesh. A face created on its own keeps
+ *  its indexes inside the object.
+ */
 class Face
 {
     private:
@@ -16,10 +24,16 @@ class Face
         int faceIndex;
 
         /**
-         * @brief pointsInFace: 3 points asociated to trianglular faces
+         * @brief pointsInFace: 3 points asociated to trianglular faces, inside
+         *  the mesh or in storage
          */
         int* pointsInFace;
 
+        /**
+         * @brief storage: 3 points of a face that does not belong to a mesh
+         */
+        int storage[3];
+
     public:
 
         /**
@@ -32,15 +46,32 @@ class Face
          * @brief Face
          * This method construct a Face class defining the following objects
          * @param newIndex :  The index of the created Face
-         * @param newPoints :  The Face indexes coordinates of the Face
+         * @param newPoints :  The Face indexes coordinates of the Face, which are copied
          */
         Face(int newIndex, int *newPoints );
 
         /**
-         * @brief ~Face
-         * This method is the destructor of a Face Class
+         * @brief Face
+         * This method construct a view of a face stored in a mesh
+         * @param owner :  The mesh that stores the face
+         * @param newIndex :  The index of the face in the mesh
+         */
+        Face(Mesh * owner, int newIndex);
+
+        /**
+         * @brief Face
+         * Copy constructor. The copy of a face of a mesh views the same face.
+         * @param other : The face to copy
+         */
+        Face(const Face & other);
+
+        /**
+         * @brief operator =
+         * Assignment operator. After it, this views the same face as other.
+         * @param other : The face to copy
+         * @return this face
          */
-        ~Face();
+        Face & operator=(const Face & other);
 
         /**
          * @brief setPointsInFace
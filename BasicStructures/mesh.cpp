@@ -1,4 +1,10 @@
 #include "mesh.h"
+#include <atomic>
+
+/**
+ * @brief lastRevision: last revision given to a mesh, shared by all of them
+ */
+static atomic<unsigned long long> lastRevision(0);
 
 /**
  * @brief Mesh::Mesh : Construct a mesh class with the number of
@@ -8,8 +14,9 @@
  */
 Mesh::Mesh()
 {
-    vertexes = new vector<Vertex *>();
-    faces = new vector<Face *>();
+    adjacency = NULL;
+    boundingBoxComputed = false;
+    revision = ++lastRevision;
 }
 
 /**
@@ -17,89 +24,340 @@ Mesh::Mesh()
  */
 Mesh::~Mesh()
 {
-    delete faces;
-    delete vertexes;
+    delete adjacency;
+}
+
+/**
+ * @brief Mesh::getRevision: Results computed from the mesh can be reused
+ *  while its revision does not change. Two different meshes never have the
+ *  same revision, even if one is created where the other was deleted.
+ *  Changes made through the coordinates of a Vertex view are not tracked.
+ * @return the stamp of the current content of the mesh
+ */
+unsigned long long Mesh::getRevision()
+{
+    return revision;
+}
+
+/**
+ * @brief Mesh::reserve: Allocates memory in advance for the vertexes and faces
+ * @param numVertexes: expected number of vertexes
+ * @param numFaces: expected number of faces
+ */
+void Mesh::reserve(int numVertexes, int numFaces)
+{
+    coordinates.reserve(3 * (size_t)numVertexes);
+    triangles.reserve(3 * (size_t)numFaces);
+}
+
+/**
+ * @brief Mesh::setData: Replaces the content of the mesh. The arrays are
+ *  swapped with the ones of the mesh, so no copy is made.
+ * @param newCoordinates: X Y Z coordinates of every vertex
+ * @param newTriangles: indexes of the 3 vertexes of every face
+ */
+void Mesh::setData(vector<double> & newCoordinates, vector<int> & newTriangles)
+{
+    coordinates.swap(newCoordinates);
+    triangles.swap(newTriangles);
+    sourceFaces.clear();
+    invalidateAdjacency();
 }
 
 /**
  * @brief Mesh::setVertex: Defines the value of a vertex inside the Mesh
- * @param newVertex: The value of the vertex
+ * @param newVertex: The vertex whose coordinates are copied
  * @param position:  Position to include the vertex
  */
 void Mesh::setVertex(Vertex * newVertex , int position)
 {
-    if( (unsigned int)position < vertexes->size())
+    if( (unsigned int)position < (unsigned int)getNumVertexes())
     {
-        vertexes->at(position) = newVertex;
+        double * newCoordinates = newVertex->getCoordinates();
+        for (int i = 0; i < 3; i++)
+        {
+            coordinates[3 * position + i] = newCoordinates[i];
+        }
+        boundingBoxComputed = false;
+        revision = ++lastRevision;
     }
 }
 
 /**
  * @brief Mesh::addNewVertex: Add a new vertex in the mesh
- * @param newVertex: The new vertex to include in the mesh
+ * @param newVertex: The vertex whose coordinates are copied
  */
 void Mesh::addNewVertex(Vertex * newVertex)
 {
+    double * newCoordinates = newVertex->getCoordinates();
+    addNewVertex(newCoordinates[0], newCoordinates[1], newCoordinates[2]);
+}
 
-    vertexes->push_back(newVertex);
+/**
+ * @brief Mesh::addNewVertex: Add a new vertex at the end of the mesh
+ * @param x: Coordinate value in X
+ * @param y: Coordinate value in Y
+ * @param z: Coordinate value in Z
+ * @return the index of the new vertex
+ */
+int Mesh::addNewVertex(double x, double y, double z)
+{
+    coordinates.push_back(x);
+    coordinates.push_back(y);
+    coordinates.push_back(z);
+    invalidateAdjacency();
+    return getNumVertexes() - 1;
 }
 
 /**
  * @brief Mesh::setFace: Defines a face inside the Mesh
- * @param newFace: The face to include
+ * @param newFace: The face whose indexes are copied
  * @param position:  Position to include the face
  */
 void Mesh::setFace(Face * newFace, int position)
 {
-    if( (unsigned int)position < faces->size())
+    if( (unsigned int)position < (unsigned int)getNumFaces())
     {
-        faces->at(position)=newFace;
+        int * newPoints = newFace->getPointsInFace();
+        for (int i = 0; i < 3; i++)
+        {
+            triangles[3 * position + i] = newPoints[i];
+        }
+        invalidateAdjacency();
     }
 }
 
 /**
  * @brief Mesh::addNewVertex: Add a new face at the end of the mesh
- * @param newVertex: The new face to include in the mesh
+ * @param newVertex: The face whose indexes are copied
  */
 void Mesh::addNewFace(Face * newFace)
 {
-    faces->push_back(newFace);
+    int * newPoints = newFace->getPointsInFace();
+    addNewFace(newPoints[0], newPoints[1], newPoints[2]);
 }
 
 /**
- * @brief getAllFaces : Return a vector of all the Faces in the mesh
+ * @brief Mesh::addNewFace: Add a new face at the end of the mesh
+ * @param point1: index of point N1
+ * @param point2: index of point N2
+ * @param point3: index of point N3
+ * @return the index of the new face
+ */
+int Mesh::addNewFace(int point1, int point2, int point3)
+{
+    triangles.push_back(point1);
+    triangles.push_back(point2);
+    triangles.push_back(point3);
+    if (!sourceFaces.empty())
+    {
+        sourceFaces.push_back(sourceFaces.back() + 1);
+    }
+    invalidateAdjacency();
+    return getNumFaces() - 1;
+}
+
+/**
+ * @brief Mesh::setSourceFaces: Defines the face of the file every triangle
+ *  comes from. The array is swapped with the one of the mesh.
+ * @param newSourceFaces: one index per triangle, in increasing order, or an
+ *  empty array if every triangle is a face of the file
+ */
+void Mesh::setSourceFaces(vector<int> & newSourceFaces)
+{
+    sourceFaces.swap(newSourceFaces);
+}
+
+/**
+ * @brief Mesh::hasSourceFaces
+ * @return true if some faces of the file were split in several triangles
+ */
+bool Mesh::hasSourceFaces()
+{
+    return !sourceFaces.empty();
+}
+
+/**
+ * @brief Mesh::getSourceFaces
+ * @return a pointer to the face of the file every triangle comes from, NULL if
+ *  every triangle is a face of the file
+ */
+const int * Mesh::getSourceFaces()
+{
+    return sourceFaces.empty()? NULL : sourceFaces.data();
+}
+
+/**
+ * @brief Mesh::getSourceFace
+ * @param face: index of a triangle of the mesh
+ * @return the index of the face of the file the triangle comes from
+ */
+int Mesh::getSourceFace(int face)
+{
+    return sourceFaces.empty()? face : sourceFaces[face];
+}
+
+/**
+ * @brief Mesh::getNumSourceFaces
+ * @return the number of faces of the file the triangles come from
+ */
+int Mesh::getNumSourceFaces()
+{
+    return sourceFaces.empty()? getNumFaces() : sourceFaces.back() + 1;
+}
+
+/**
+ * @brief Mesh::getNumVertexes
+ * @return the number of vertexes in the mesh
+ */
+int Mesh::getNumVertexes()
+{
+    return coordinates.size() / 3;
+}
+
+/**
+ * @brief Mesh::getNumFaces
+ * @return the number of faces in the mesh
+ */
+int Mesh::getNumFaces()
+{
+    return triangles.size() / 3;
+}
+
+/**
+ * @brief Mesh::getCoordinates: Returns a pointer to the X Y Z coordinates
+ *  of all the vertexes, one after the other
  * @return
  */
-vector<Face *> * Mesh::getAllFaces()
+double * Mesh::getCoordinates()
 {
-    return faces;
+    return coordinates.data();
 }
 
 /**
- * @brief getAllVertexes: Return a vector of all the vertex in the mesh
+ * @brief Mesh::getTriangles: Returns a pointer to the indexes of the 3
+ *  vertexes of all the faces, one after the other
  * @return
  */
-vector<Vertex * > *  Mesh::getAllVertexes()
+int * Mesh::getTriangles()
 {
-    return vertexes;
+    return triangles.data();
 }
 
 /**
- * @brief getFace:  Returns the face on a given position
+ * @brief getFace:  Returns a view of the face on a given position
  * @param position
  * @return
  */
-Face * Mesh::getFace(int position)
+Face Mesh::getFace(int position)
 {
-    return faces->at(position);
+    return Face(this, position);
 }
 
 /**
- * @brief getFace:  Returns the face on a given position
+ * @brief getVertex:  Returns a view of the vertex on a given position
  * @param position
  * @return
  */
-Vertex * Mesh::getVertex(int position)
+Vertex Mesh::getVertex(int position)
+{
+    return Vertex(this, position);
+}
+
+/**
+ * @brief getAdjacency: Returns the vertex-to-vertex and vertex-to-face
+ *  adjacency of the mesh, building it on the first call
+ * @return
+ */
+Adjacency * Mesh::getAdjacency()
+{
+    if (adjacency == NULL)
+    {
+        adjacency = new Adjacency();
+        adjacency->build(triangles.data(), getNumFaces(), getNumVertexes());
+    }
+    return adjacency;
+}
+
+/**
+ * @brief hasAdjacency
+ * @return true if the adjacency has already been built or set
+ */
+bool Mesh::hasAdjacency()
+{
+    return adjacency != NULL;
+}
+
+/**
+ * @brief setAdjacency: Replaces the adjacency of the mesh with one computed
+ *  before. The mesh takes ownership of it.
+ * @param newAdjacency: the adjacency of the current faces of the mesh
+ */
+void Mesh::setAdjacency(Adjacency * newAdjacency)
+{
+    if (newAdjacency != adjacency)
+    {
+        delete adjacency;
+        adjacency = newAdjacency;
+    }
+}
+
+/**
+ * @brief getBoundingBox: Returns the box aligned with the axes that contains
+ *  all the vertexes, computing it on the first call
+ * @param minimum: receives the minimum X Y Z of the vertexes
+ * @param maximum: receives the maximum X Y Z of the vertexes
+ */
+void Mesh::getBoundingBox(double * minimum, double * maximum)
+{
+    if (!boundingBoxComputed)
+    {
+        for (int i = 0; i < 3; i++)
+        {
+            boundingBox[i] = coordinates.empty()? 0.0 : coordinates[i];
+            boundingBox[3 + i] = boundingBox[i];
+        }
+        for (size_t j = 0; j < coordinates.size(); j += 3)
+        {
+            for (int i = 0; i < 3; i++)
+            {
+                boundingBox[i] = min(boundingBox[i], coordinates[j + i]);
+                boundingBox[3 + i] = max(boundingBox[3 + i], coordinates[j + i]);
+            }
+        }
+        boundingBoxComputed = true;
+    }
+    for (int i = 0; i < 3; i++)
+    {
+        minimum[i] = boundingBox[i];
+        maximum[i] = boundingBox[3 + i];
+    }
+}
+
+/**
+ * @brief setBoundingBox: Defines the bounding box of the vertexes when it is
+ *  already known, e.g. read from a file
+ * @param minimum: minimum X Y Z of the vertexes
+ * @param maximum: maximum X Y Z of the vertexes
+ */
+void Mesh::setBoundingBox(const double * minimum, const double * maximum)
+{
+    for (int i = 0; i < 3; i++)
+    {
+        boundingBox[i] = minimum[i];
+        boundingBox[3 + i] = maximum[i];
+    }
+    boundingBoxComputed = true;
+}
+
+/**
+ * @brief invalidateAdjacency: Discards the adjacency and the bounding box
+ *  after a modification
+ */
+void Mesh::invalidateAdjacency()
 {
-    return vertexes->at(position);
+    delete adjacency;
+    adjacency = NULL;
+    boundingBoxComputed = false;
+    revision = ++lastRevision;
 }
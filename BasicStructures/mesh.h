@@ -2,23 +2,63 @@
 #define MESH_H
 
 #include <vector>
+#include "adjacency.h"
 #include "face.h"
 #include "vertex.h"
 
 using namespace std;
 
+/**
+ * @brief The Mesh class stores a triangular mesh as a structure of arrays: the
+ *  coordinates of all the vertexes in one contiguous array (x0 y0 z0 x1 ...)
+ *  and the vertex indexes of all the faces in another (a0 b0 c0 a1 ...).
+ *  Vertex and Face objects returned by the mesh are views of those arrays.
+ */
 class Mesh
 {
     private:
         /**
-         * @brief faces:  It is a pointer to the vector of pointers to faces contained in the mesh
+         * @brief coordinates: X Y Z coordinates of every vertex, one after the other
          */
-        vector<Face *> * faces;
+        vector<double> coordinates;
 
         /**
-         * @brief vertexes:  It is a pointer to the vector of pointers to vertexes contained in the mesh
+         * @brief triangles: indexes of the 3 vertexes of every face, one after the other
          */
-        vector<Vertex *> * vertexes;
+        vector<int> triangles;
+
+        /**
+         * @brief sourceFaces: for meshes read from polygonal faces, the index
+         *  of the face of the file every triangle comes from. Empty when every
+         *  triangle is a face of the file.
+         */
+        vector<int> sourceFaces;
+
+        /**
+         * @brief adjacency: CSR adjacency of the mesh, built on demand and
+         *  discarded whenever a vertex or a face changes
+         */
+        Adjacency * adjacency;
+
+        /**
+         * @brief boundingBox: minimum X Y Z followed by maximum X Y Z of the
+         *  vertexes, valid only if boundingBoxComputed is true
+         */
+        double boundingBox[6];
+        bool boundingBoxComputed;
+
+        /**
+         * @brief revision: stamp of the current content of the mesh, unique
+         *  among all the meshes of the program and renewed on every change of
+         *  a vertex or a face
+         */
+        unsigned long long revision;
+
+        /**
+         * @brief invalidateAdjacency: Discards the adjacency and the bounding
+         *  box after a modification, and gives the mesh a new revision
+         */
+        void invalidateAdjacency();
 
     public:
 
@@ -32,59 +72,186 @@ class Mesh
          */
         ~Mesh();
 
+        /**
+         * @brief getRevision: Results computed from the mesh can be reused
+         *  while its revision does not change. Two different meshes never
+         *  have the same revision, even if one is created where the other
+         *  was deleted. Changes made through the coordinates of a Vertex view
+         *  are not tracked.
+         * @return the stamp of the current content of the mesh
+         */
+        unsigned long long getRevision();
+
+        /**
+         * @brief reserve: Allocates memory in advance for the vertexes and faces
+         * @param numVertexes: expected number of vertexes
+         * @param numFaces: expected number of faces
+         */
+        void reserve(int numVertexes, int numFaces);
+
+        /**
+         * @brief setData: Replaces the content of the mesh. The arrays are
+         *  swapped with the ones of the mesh, so no copy is made.
+         * @param newCoordinates: X Y Z coordinates of every vertex
+         * @param newTriangles: indexes of the 3 vertexes of every face
+         */
+        void setData(vector<double> & newCoordinates, vector<int> & newTriangles);
+
         /**
          * @brief setVertex: Defines a vertex inside the Mesh
-         * @param newVertex: A pointer to the vertex to include
+         * @param newVertex: A pointer to the vertex whose coordinates are copied
          * @param position:  Position to include the vertex
          */
         void setVertex(Vertex * newVertex , int position);
 
         /**
          * @brief addNewVertex: Add a new vertex at the end of the mesh
-         * @param newVertex: A pointer to the new vertex to include in the mesh
+         * @param newVertex: A pointer to the vertex whose coordinates are copied
          */
         void addNewVertex(Vertex * newVertex);
 
+        /**
+         * @brief addNewVertex: Add a new vertex at the end of the mesh
+         * @param x: Coordinate value in X
+         * @param y: Coordinate value in Y
+         * @param z: Coordinate value in Z
+         * @return the index of the new vertex
+         */
+        int addNewVertex(double x, double y, double z);
+
         /**
          * @brief setFace: Defines a face inside the Mesh
-         * @param newFace: A pointer to the face to include
+         * @param newFace: A pointer to the face whose indexes are copied
          * @param position:  Position to include the face
          */
         void setFace(Face * newFace, int position);
 
         /**
          * @brief addNewFace: Add a new face at the end of the mesh
-         * @param newFace: Pointer to the new face to include in the mesh
+         * @param newFace: Pointer to the face whose indexes are copied
          */
         void addNewFace(Face * newFace);
 
         /**
-         * @brief getAllFaces : Return a pointer to a vector of pointers to all the Faces in the mesh
+         * @brief addNewFace: Add a new face at the end of the mesh
+         * @param point1: index of point N1
+         * @param point2: index of point N2
+         * @param point3: index of point N3
+         * @return the index of the new face
+         */
+        int addNewFace(int point1, int point2, int point3);
+
+        /**
+         * @brief setSourceFaces: Defines the face of the file every triangle
+         *  comes from. The array is swapped with the one of the mesh.
+         * @param newSourceFaces: one index per triangle, in increasing order,
+         *  or an empty array if every triangle is a face of the file
+         */
+        void setSourceFaces(vector<int> & newSourceFaces);
+
+        /**
+         * @brief hasSourceFaces
+         * @return true if some faces of the file were split in several triangles
+         */
+        bool hasSourceFaces();
+
+        /**
+         * @brief getSourceFaces
+         * @return a pointer to the face of the file every triangle comes from,
+         *  NULL if every triangle is a face of the file
+         */
+        const int * getSourceFaces();
+
+        /**
+         * @brief getSourceFace
+         * @param face: index of a triangle of the mesh
+         * @return the index of the face of the file the triangle comes from
+         */
+        int getSourceFace(int face);
+
+        /**
+         * @brief getNumSourceFaces
+         * @return the number of faces of the file the triangles come from
+         */
+        int getNumSourceFaces();
+
+        /**
+         * @brief getNumVertexes
+         * @return the number of vertexes in the mesh
+         */
+        int getNumVertexes();
+
+        /**
+         * @brief getNumFaces
+         * @return the number of faces in the mesh
+         */
+        int getNumFaces();
+
+        /**
+         * @brief getCoordinates: Returns a pointer to the X Y Z coordinates of
+         *  all the vertexes, one after the other
          * @return
          */
-        vector<Face * > * getAllFaces();
+        double * getCoordinates();
 
         /**
-         * @brief getAllVertexes: Returns a pointer to a vector of pointers to all the vertex in the mesh
+         * @brief getTriangles: Returns a pointer to the indexes of the 3 vertexes
+         *  of all the faces, one after the other. Faces modified through this
+         *  pointer keep the adjacency computed before.
          * @return
          */
-        vector<Vertex *> * getAllVertexes();
+        int * getTriangles();
 
         /**
-         * @brief getFace:  Returns a pointer to the face on a given position
+         * @brief getFace:  Returns a view of the face on a given position
          * @param position
          * @return
          */
-        Face * getFace(int position);
+        Face getFace(int position);
 
         /**
-         * @brief getVertex: Returns a pointer to a vertex in a given position
+         * @brief getVertex: Returns a view of the vertex on a given position
          * @param position
          * @return
          */
-        Vertex * getVertex(int position);
+        Vertex getVertex(int position);
+
+        /**
+         * @brief getAdjacency: Returns the vertex-to-vertex and vertex-to-face
+         *  adjacency of the mesh, building it on the first call. It must not be
+         *  called concurrently with a modification of the mesh.
+         * @return
+         */
+        Adjacency * getAdjacency();
+
+        /**
+         * @brief hasAdjacency
+         * @return true if the adjacency has already been built or set
+         */
+        bool hasAdjacency();
+
+        /**
+         * @brief setAdjacency: Replaces the adjacency of the mesh with one
+         *  computed before. The mesh takes ownership of it.
+         * @param newAdjacency: the adjacency of the current faces of the mesh
+         */
+        void setAdjacency(Adjacency * newAdjacency);
 
+        /**
+         * @brief getBoundingBox: Returns the box aligned with the axes that
+         *  contains all the vertexes, computing it on the first call
+         * @param minimum: receives the minimum X Y Z of the vertexes
+         * @param maximum: receives the maximum X Y Z of the vertexes
+         */
+        void getBoundingBox(double * minimum, double * maximum);
 
+        /**
+         * @brief setBoundingBox: Defines the bounding box of the vertexes
+         *  when it is already known, e.g. read from a file
+         * @param minimum: minimum X Y Z of the vertexes
+         * @param maximum: maximum X Y Z of the vertexes
+         */
+        void setBoundingBox(const double * minimum, const double * maximum);
 };
 
 #endif // MESH_H
@@ -1,4 +1,5 @@
 #include "vertex.h"
+#include "mesh.h"
 
 /**
  * @brief Vertex::Vertex
@@ -7,85 +8,73 @@
 Vertex::Vertex()
 {
     index = 0;
-    this->coordinates =  new (nothrow) double[3] ;
+    mesh = NULL;
+    coordinates = storage;
 
     for (int i=0; i<3; i++)
     {
        *(coordinates +i ) = 0;
     }
-
-    facesContainingPoint = new vector<int>;
 }
 
 /**
  * @brief Vertex::Vertex
  * This method construct a Vertex class defining the following objects
  * @param newIndex :  The index of the created Vertex
- * @param newCoordinates :  The 3D coordinates of the Vertex
+ * @param newCoordinates :  The 3D coordinates of the Vertex, which are copied
  */
 Vertex::Vertex(int newIndex, double* newCoordinates)
 {
     index = newIndex;
-    coordinates =  new (nothrow) double[3] ;
+    mesh = NULL;
+    coordinates = storage;
 
-    if (coordinates == nullptr)
-    {
-        cout << "Error: memory could not be allocated";
-    }
-    else
+    for (int i=0; i<3; i++)
     {
-        for (int i=0; i<3; i++)
-        {
-           *(coordinates +i ) = *(newCoordinates + i);
-        }
+       *(coordinates +i ) = *(newCoordinates + i);
     }
-
-    facesContainingPoint = new vector<int>;
 }
 
 /**
- * @brief Vertex::~Vertex
- * This method is the destructor of a Vertex Class, it deletes its objects
+ * @brief Vertex::Vertex
+ * This method construct a view of a vertex stored in a mesh
+ * @param owner :  The mesh that stores the vertex
+ * @param newIndex :  The index of the vertex in the mesh
  */
-Vertex::~Vertex()
+Vertex::Vertex(Mesh * owner, int newIndex)
 {
-    delete[] coordinates;
-    delete facesContainingPoint;
+    index = newIndex;
+    mesh = owner;
+    coordinates = owner->getCoordinates() + 3 * newIndex;
 }
 
 /**
- * @brief Vertex::addNewFace
- * This method adds a face that contains the given vertex.
- * @param faceNumber: Face number wich contains the vertex.
+ * @brief Vertex::Vertex
+ * Copy constructor. The copy of a vertex of a mesh views the same vertex.
+ * @param other : The vertex to copy
  */
-void Vertex::addNewFace(int faceNumber)
+Vertex::Vertex(const Vertex & other)
 {
-    vector<int>::iterator it;
-    it = find ( (*facesContainingPoint).begin(), (*facesContainingPoint).end(), faceNumber);
-    if(it == (*facesContainingPoint).end() )
-    {
-        //Element not found in facesContainingPoint
-        (*facesContainingPoint).push_back(faceNumber);
-    }
+    *this = other;
 }
 
 /**
- * @brief Vertex::DeleteFace
- * This method deletes a face that contains the given vertex.
- * @param faceNumber: Face to delete.
+ * @brief Vertex::operator =
+ * Assignment operator. After it, this views the same vertex as other.
+ * @param other : The vertex to copy
+ * @return this vertex
  */
-void Vertex::deleteFace(int faceNumber)
+Vertex & Vertex::operator=(const Vertex & other)
 {
-    vector<int>::iterator it;
-    it = find ( ( *facesContainingPoint ).begin(),
-                ( *facesContainingPoint ).end(),
-                faceNumber );
-
-    if( it != ( *facesContainingPoint ).end() )
+    index = other.index;
+    mesh = other.mesh;
+    for (int i=0; i<3; i++)
     {
-        //Element found in facesContainingPoint
-        ( * facesContainingPoint ).erase(it);
+        storage[i] = other.storage[i];
     }
+    // A vertex without mesh must point to its own copy of the coordinates
+    coordinates = (other.coordinates == other.storage)? storage : other.coordinates;
+    return *this;
 }
 
 /**
@@ -146,9 +135,16 @@ double* Vertex::getCoordinates()
 
 /**
  * @brief Vertex::getFaces
- * @return a std::vector containing all the faces that contains the vertex
+ * @return a std::vector containing all the faces that contains the vertex,
+ *  empty if the vertex does not belong to a mesh
  */
 vector<int> Vertex::getFaces()
 {
-    return *(this->facesContainingPoint);
+    if (mesh == NULL)
+    {
+        return vector<int>();
+    }
+    Adjacency * adjacency = mesh->getAdjacency();
+    const int * faces = adjacency->getFaces(index);
+    return vector<int>(faces, faces + adjacency->getNumFaces(index));
 }
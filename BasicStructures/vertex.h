@@ -10,6 +10,14 @@ using std::cout;
 using std::nothrow;
 using std::vector;
 
+class Mesh;
+
+/**
+ * @brief The Vertex class is a lightweight view of a vertex. A vertex returned
+ *  by a Mesh reads and writes the coordinates stored in the mesh, and stays
+ *  valid until vertexes are added to that mesh. A vertex created on its own
+ *  keeps its coordinates inside the object.
+ */
 class Vertex
 {
     private:
@@ -19,14 +27,19 @@ class Vertex
         int index;
 
         /**
-         * @brief coordinates: (X Y Z) coordinates
+         * @brief coordinates: (X Y Z) coordinates, inside the mesh or in storage
          */
         double * coordinates;
 
         /**
-         * @brief facesContainingPoint: Pointer to vector of integers containing faces that contain the point
+         * @brief storage: (X Y Z) coordinates of a vertex that does not belong to a mesh
          */
-        vector<int> * facesContainingPoint;
+        double storage[3];
+
+        /**
+         * @brief mesh: Mesh the vertex belongs to, NULL if it has its own coordinates
+         */
+        Mesh * mesh;
 
     public:
 
@@ -40,29 +53,32 @@ class Vertex
          * @brief Vertex
          * This method construct a Vertex class defining the following objects
          * @param newIndex :  The index of the created Vertex
-         * @param newCoordinates :  The 3D coordinates of the Vertex
+         * @param newCoordinates :  The 3D coordinates of the Vertex, which are copied
          */
         Vertex(int newIndex, double* newCoordinates);
 
         /**
-         * @brief ~Vertex
-         * This method is the destructor of a Vertex Class, it deletes its objects
+         * @brief Vertex
+         * This method construct a view of a vertex stored in a mesh
+         * @param owner :  The mesh that stores the vertex
+         * @param newIndex :  The index of the vertex in the mesh
          */
-        ~Vertex();
+        Vertex(Mesh * owner, int newIndex);
 
         /**
-         * @brief addNewFace
-         * This method adds a face that contains the given vertex.
-         * @param faceNumber: Face number wich contains the vertex.
+         * @brief Vertex
+         * Copy constructor. The copy of a vertex of a mesh views the same vertex.
+         * @param other : The vertex to copy
          */
-        void addNewFace(int faceNumber);
+        Vertex(const Vertex & other);
 
         /**
-         * @brief DeleteFace
-         * This method deletes a face that contains the given vertex.
-         * @param faceNumber: Face to delete.
+         * @brief operator =
+         * Assignment operator. After it, this views the same vertex as other.
+         * @param other : The vertex to copy
+         * @return this vertex
          */
-        void deleteFace(int faceNumber);
+        Vertex & operator=(const Vertex & other);
 
         /**
          * @brief setCoordinates
@@ -102,7 +118,8 @@ class Vertex
 
         /**
          * @brief getFaces
-         * @return a std::vector containing all the faces that contains the vertex
+         * @return a std::vector containing all the faces that contains the vertex,
+         *  empty if the vertex does not belong to a mesh
          */
         vector<int> getFaces();
 
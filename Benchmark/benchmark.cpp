@@ -0,0 +1,322 @@
+#include "benchmark.h"
+#include "meshgenerator.h"
+#include "BasicStructures/adjacency.h"
+#include "FileManager/filemanager.h"
+#include <QFile>
+#include <QHash>
+#include <algorithm>
+#include <chrono>
+#include <limits>
+
+/**
+ * @brief minimumDifference Differences with the baseline below this number of
+ *  seconds are timer noise, and are never regressions
+ */
+static const double minimumDifference = 0.001;
+
+/**
+ * @brief Benchmark prepares a benchmark
+ * @param options what the benchmark runs
+ * @param log stream where the progress is written, it may be NULL
+ */
+Benchmark::Benchmark(const BenchmarkOptions & options, QTextStream * log)
+    : options(options), log(log)
+{
+}
+
+/**
+ * @brief measure runs an operation some times and keeps its lowest wall time
+ * @param run the operation
+ * @param setUp function called before every run, which is not timed
+ * @return the lowest wall time, in seconds
+ */
+double Benchmark::measure(const std::function<void()> & run, const std::function<void()> & setUp)
+{
+    typedef std::chrono::steady_clock Clock;
+    double best = std::numeric_limits<double>::infinity();
+    for(int i = 0; i < std::max(1, options.repetitions); i++)
+    {
+        if(setUp)
+        {
+            setUp();
+        }
+        Clock::time_point start = Clock::now();
+        run();
+        std::chrono::duration<double> elapsed = Clock::now() - start;
+        best = std::min(best, elapsed.count());
+    }
+    return best;
+}
+
+/**
+ * @brief makeResult
+ * @param mesh name of the mesh
+ * @param numVertexes number of vertexes of the mesh
+ * @param operation name of the operation
+ * @param numRings number of rings, 0 if the operation does not use them
+ * @param numThreads number of threads
+ * @param seconds the measure
+ * @return the measure as a JSON object, where more fields may be added
+ */
+QJsonObject Benchmark::makeResult(const QString & mesh, int numVertexes, const QString & operation,
+                                  int numRings, int numThreads, double seconds)
+{
+    QJsonObject result;
+    result["mesh"] = mesh;
+    result["vertexes"] = numVertexes;
+    result["operation"] = operation;
+    result["rings"] = numRings;
+    result["threads"] = numThreads;
+    result["seconds"] = seconds;
+    return result;
+}
+
+/**
+ * @brief addResult adds a measure to a list and writes it to the log
+ * @param results the list
+ * @param result the measure, as returned by makeResult
+ */
+void Benchmark::addResult(QJsonArray & results, const QJsonObject & result)
+{
+    results.append(result);
+    if(log != NULL)
+    {
+        *log << getKey(result) << ": " << QString::number(result["seconds"].toDouble(), 'f', 6) << " s" << endl;
+    }
+}
+
+/**
+ * @brief benchmarkParsing writes a mesh as OFF and binary PLY files and
+ *  times their reading with every number of threads
+ * @param name name of the mesh
+ * @param mesh the mesh
+ * @param results list where the measures are added
+ */
+void Benchmark::benchmarkParsing(const QString & name, Mesh * mesh, QJsonArray & results)
+{
+    int numVertexes = mesh->getNumVertexes();
+    QString offFileName = directory.path() + "/" + name + ".off";
+    QString plyFileName = directory.path() + "/" + name + ".ply";
+    FileManager fileManager;
+    QFile plyFile(plyFileName);
+    if(!MeshGenerator::writeOFF(mesh, offFileName) || !fileManager.writePLY(mesh, &plyFile, true))
+    {
+        if(log != NULL)
+        {
+            *log << "Could not write " << name << " to " << directory.path() << endl;
+        }
+        return;
+    }
+    plyFile.close();
+
+    foreach(int numThreads, options.threads)
+    {
+        fileManager.setNumThreads(numThreads);
+        double seconds = measure([&]()
+        {
+            QFile offFile(offFileName);
+            delete fileManager.readOFF(&offFile);
+        });
+        addResult(results, makeResult(name, numVertexes, "parse_off", 0, numThreads, seconds));
+
+        seconds = measure([&]()
+        {
+            QFile file(plyFileName);
+            delete fileManager.readPLY(&file);
+        });
+        addResult(results, makeResult(name, numVertexes, "parse_ply", 0, numThreads, seconds));
+    }
+
+    QFile::remove(offFileName);
+    QFile::remove(plyFileName);
+}
+
+/**
+ * @brief benchmarkEngine times the adjacency, the Harris response with its
+ *  stages and both selection modes, with every number of rings and threads
+ * @param name name of the mesh
+ * @param mesh the mesh
+ * @param results list where the measures are added
+ */
+void Benchmark::benchmarkEngine(const QString & name, Mesh * mesh, QJsonArray & results)
+{
+    int numVertexes = mesh->getNumVertexes();
+
+    //The adjacency is built on a single thread, and kept by the mesh afterwards
+    double seconds = measure([&]()
+    {
+        Adjacency adjacency;
+        adjacency.build(mesh->getTriangles(), mesh->getNumFaces(), numVertexes);
+    });
+    addResult(results, makeResult(name, numVertexes, "adjacency", 0, 1, seconds));
+    mesh->getAdjacency();
+
+    Engine engine;
+    StageProfile profile;
+    foreach(int numThreads, options.threads)
+    {
+        engine.setNumThreads(numThreads);
+        foreach(int numRings, options.rings)
+        {
+            //The stages are reported from the fastest repetition
+            VectorXd harrisValues;
+            StageProfile fastest;
+            double bestSeconds = std::numeric_limits<double>::infinity();
+            engine.setProfile(&profile);
+            for(int i = 0; i < std::max(1, options.repetitions); i++)
+            {
+                engine.clearCoefficients();
+                profile.reset();
+                auto start = StageProfile::Clock::now();
+                harrisValues = engine.computeHarrisResponses(mesh, numRings, options.k);
+                std::chrono::duration<double> elapsed = StageProfile::Clock::now() - start;
+                if(elapsed.count() < bestSeconds)
+                {
+                    bestSeconds = elapsed.count();
+                    fastest = profile;
+                }
+            }
+            engine.setProfile(NULL);
+            addResult(results, makeResult(name, numVertexes, "harris", numRings, numThreads, bestSeconds));
+
+            for(int stage = STAGE_ADJACENCY; stage <= STAGE_RESPONSE; stage++)
+            {
+                ProfileStage profileStage = static_cast<ProfileStage>(stage);
+                if(fastest.getCalls(profileStage) > 0)
+                {
+                    QString operation = QString("stage_") + StageProfile::getStageName(profileStage);
+                    addResult(results, makeResult(name, numVertexes, operation, numRings, numThreads,
+                                                  fastest.getSeconds(profileStage)));
+                }
+            }
+
+            //The pre-selection and the sorting are part of both selection modes
+            const SelectionMode modes[2] = {SelectionMode::FRACTION, SelectionMode::CLUSTERING};
+            const char * modeNames[2] = {"select_fraction", "select_clustering"};
+            const double percentages[2] = {options.percentageOfPoints, options.clusteringPercentage};
+            for(int mode = 0; mode < 2; mode++)
+            {
+                vector<int> * interestPoints = NULL;
+                seconds = measure([&]()
+                {
+                    interestPoints = engine.selectInterestPoints(
+                        mesh, harrisValues, percentages[mode], modes[mode]);
+                }, [&]()
+                {
+                    delete interestPoints;
+                    interestPoints = NULL;
+                });
+
+                QJsonObject result = makeResult(name, numVertexes, modeNames[mode], numRings, numThreads, seconds);
+                result["points"] = int(interestPoints->size());
+                addResult(results, result);
+                delete interestPoints;
+            }
+        }
+    }
+}
+
+/**
+ * @brief run runs the whole benchmark
+ * @return every measure, in the order they were taken. Empty if the
+ *  temporary files could not be written.
+ */
+QJsonArray Benchmark::run()
+{
+    QJsonArray results;
+    if(!directory.isValid())
+    {
+        if(log != NULL)
+        {
+            *log << "Could not create a temporary directory" << endl;
+        }
+        return results;
+    }
+
+    foreach(const QString & name, options.meshes)
+    {
+        foreach(int size, options.sizes)
+        {
+            Mesh * mesh = MeshGenerator::generate(name, size);
+            if(mesh == NULL)
+            {
+                if(log != NULL)
+                {
+                    *log << "Unknown mesh " << name << endl;
+                }
+                break;
+            }
+            if(log != NULL)
+            {
+                *log << name << ": " << mesh->getNumVertexes() << " vertexes, "
+                     << mesh->getNumFaces() << " faces" << endl;
+            }
+
+            benchmarkParsing(name, mesh, results);
+            benchmarkEngine(name, mesh, results);
+            delete mesh;
+        }
+    }
+    return results;
+}
+
+/**
+ * @brief getKey
+ * @param result a measure
+ * @return what identifies the measure in another run, every field but seconds and points
+ */
+QString Benchmark::getKey(const QJsonObject & result)
+{
+    return QString("%1/%2/%3/rings=%4/threads=%5")
+        .arg(result["mesh"].toString())
+        .arg(result["vertexes"].toInt())
+        .arg(result["operation"].toString())
+        .arg(result["rings"].toInt())
+        .arg(result["threads"].toInt());
+}
+
+/**
+ * @brief compare compares the measures of a run with the ones of a baseline
+ *  that have the same key, and writes the ratio of every pair
+ * @param results the measures of the run
+ * @param baseline the measures of the baseline
+ * @param tolerance how much slower than the baseline a measure can be, as a
+ *  fraction of it, before it is a regression
+ * @param report stream where the comparison is written
+ * @return the number of regressions
+ */
+int Benchmark::compare(const QJsonArray & results, const QJsonArray & baseline, double tolerance, QTextStream & report)
+{
+    QHash<QString, double> baselineSeconds;
+    foreach(const QJsonValue & value, baseline)
+    {
+        QJsonObject result = value.toObject();
+        baselineSeconds.insert(getKey(result), result["seconds"].toDouble());
+    }
+
+    int numRegressions = 0;
+    int numCompared = 0;
+    foreach(const QJsonValue & value, results)
+    {
+        QJsonObject result = value.toObject();
+        QString key = getKey(result);
+        if(!baselineSeconds.contains(key))
+        {
+            continue;
+        }
+
+        double before = baselineSeconds.value(key);
+        double after = result["seconds"].toDouble();
+        double ratio = (before > 0)? after / before : 1.0;
+        bool regression = after > before * (1 + tolerance) && after - before > minimumDifference;
+        report << key << ": " << QString::number(before, 'f', 6) << " s -> " << QString::number(after, 'f', 6)
+               << " s (x" << QString::number(ratio, 'f', 2) << ")" << (regression? " REGRESSION" : "") << endl;
+        numCompared++;
+        if(regression)
+        {
+            numRegressions++;
+        }
+    }
+    report << numCompared << " measures compared, " << numRegressions << " regressions" << endl;
+    return numRegressions;
+}
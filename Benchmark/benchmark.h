@@ -0,0 +1,132 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QList>
+#include <QStringList>
+#include <QTemporaryDir>
+#include <QTextStream>
+#include <functional>
+#include "BasicStructures/mesh.h"
+#include "Engine/engine.h"
+#include "Engine/stageprofile.h"
+
+/**
+ * @brief The BenchmarkOptions struct lists what the benchmark runs: every
+ *  mesh at every size, and the Engine with every number of rings and threads.
+ *  The percentage of the CLUSTERING selection is given apart, because it
+ *  sets the radius of the clusters instead of the number of points.
+ */
+struct BenchmarkOptions
+{
+    QStringList meshes;
+    QList<int> sizes;
+    QList<int> rings;
+    QList<int> threads;
+    int repetitions;
+    double k;
+    double percentageOfPoints;
+    double clusteringPercentage;
+};
+
+/**
+ * @brief The Benchmark class times the FileManager and the Engine on the
+ *  meshes of the MeshGenerator. Every measure is the lowest wall time of
+ *  some repetitions, and is kept as a JSON object with the fields
+ *  mesh, vertexes, operation, rings, threads and seconds. The operations are
+ *  "parse_off", "parse_ply", "adjacency", "harris", "select_fraction",
+ *  "select_clustering" and one "stage_<name>" per stage of the StageProfile
+ *  that computeHarrisResponses runs, whose seconds are added over the
+ *  threads. The selections also keep the number of points selected.
+ */
+class Benchmark
+{
+private:
+    BenchmarkOptions options;
+    QTemporaryDir directory;
+    QTextStream * log;
+
+    /**
+     * @brief measure runs an operation some times and keeps its lowest wall time
+     * @param run the operation
+     * @param setUp function called before every run, which is not timed
+     * @return the lowest wall time, in seconds
+     */
+    double measure(const std::function<void()> & run, const std::function<void()> & setUp = {});
+
+    /**
+     * @brief makeResult
+     * @param mesh name of the mesh
+     * @param numVertexes number of vertexes of the mesh
+     * @param operation name of the operation
+     * @param numRings number of rings, 0 if the operation does not use them
+     * @param numThreads number of threads
+     * @param seconds the measure
+     * @return the measure as a JSON object, where more fields may be added
+     */
+    static QJsonObject makeResult(const QString & mesh, int numVertexes, const QString & operation,
+                                  int numRings, int numThreads, double seconds);
+
+    /**
+     * @brief addResult adds a measure to a list and writes it to the log
+     * @param results the list
+     * @param result the measure, as returned by makeResult
+     */
+    void addResult(QJsonArray & results, const QJsonObject & result);
+
+    /**
+     * @brief benchmarkParsing writes a mesh as OFF and binary PLY files and
+     *  times their reading with every number of threads
+     * @param name name of the mesh
+     * @param mesh the mesh
+     * @param results list where the measures are added
+     */
+    void benchmarkParsing(const QString & name, Mesh * mesh, QJsonArray & results);
+
+    /**
+     * @brief benchmarkEngine times the adjacency, the Harris response with its
+     *  stages and both selection modes, with every number of rings and threads
+     * @param name name of the mesh
+     * @param mesh the mesh
+     * @param results list where the measures are added
+     */
+    void benchmarkEngine(const QString & name, Mesh * mesh, QJsonArray & results);
+
+public:
+    /**
+     * @brief Benchmark prepares a benchmark
+     * @param options what the benchmark runs
+     * @param log stream where the progress is written, it may be NULL
+     */
+    Benchmark(const BenchmarkOptions & options, QTextStream * log);
+
+    /**
+     * @brief run runs the whole benchmark
+     * @return every measure, in the order they were taken. Empty if the
+     *  temporary files could not be written.
+     */
+    QJsonArray run();
+
+    /**
+     * @brief getKey
+     * @param result a measure
+     * @return what identifies the measure in another run, every field but seconds and points
+     */
+    static QString getKey(const QJsonObject & result);
+
+    /**
+     * @brief compare compares the measures of a run with the ones of a baseline
+     *  that have the same key, and writes the ratio of every pair
+     * @param results the measures of the run
+     * @param baseline the measures of the baseline
+     * @param tolerance how much slower than the baseline a measure can be, as a
+     *  fraction of it, before it is a regression. Differences below a
+     *  millisecond are never regressions.
+     * @param report stream where the comparison is written
+     * @return the number of regressions
+     */
+    static int compare(const QJsonArray & results, const QJsonArray & baseline, double tolerance, QTextStream & report);
+};
+
+#endif // BENCHMARK_H
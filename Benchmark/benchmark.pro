@@ -0,0 +1,18 @@
+QT = core
+CONFIG += c++11 console thread
+CONFIG -= app_bundle
+TARGET = benchmark
+
+DEFINES += QT_DEPRECATED_WARNINGS
+
+# BasicStructures, FileManager and Engine, without the GUI
+include(../core.pri)
+
+SOURCES += \
+        main.cpp \
+    benchmark.cpp \
+    meshgenerator.cpp
+
+HEADERS += \
+    benchmark.h \
+    meshgenerator.h
@@ -0,0 +1,135 @@
+#include "benchmark.h"
+#include "meshgenerator.h"
+#include "Engine/parallel.h"
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QFile>
+#include <QJsonDocument>
+#include <QTextStream>
+
+/**
+ * @brief parseIntegers Parses a comma separated list of positive integers
+ * @param text The list, e.g. "1,2,4"
+ * @param values The integers, replaced by the ones in the list
+ * @return false if an element is not a positive integer
+ */
+static bool parseIntegers(const QString & text, QList<int> & values)
+{
+    values.clear();
+    foreach(const QString & element, text.split(',', QString::SkipEmptyParts))
+    {
+        bool valid;
+        int value = element.trimmed().toInt(&valid);
+        if(!valid || value <= 0)
+        {
+            return false;
+        }
+        values.append(value);
+    }
+    return !values.isEmpty();
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication application(argc, argv);
+    QCoreApplication::setApplicationName("benchmark");
+    QTextStream err(stderr);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(
+        "Times the parsing of mesh files, every stage of the Engine and both selection modes "
+        "on generated meshes, and compares the results with a baseline.");
+    parser.addHelpOption();
+    QCommandLineOption meshesOption("meshes", "Meshes to generate: icosphere, torus, heightfield.",
+                                    "names", "icosphere,torus,heightfield");
+    QCommandLineOption sizesOption("sizes", "Approximate number of vertexes of every mesh, "
+                                   "from 10000 to 10000000.", "list", "10000,100000");
+    QCommandLineOption ringsOption("rings", "Numbers of rings of the neighbourhoods.", "list", "1,2,3");
+    QCommandLineOption threadsOption("threads", "Numbers of threads of the FileManager and the Engine.",
+                                     "list", QString("1,%1").arg(defaultThreadCount()));
+    QCommandLineOption repeatOption("repeat", "Repetitions of every measure, the fastest is kept.", "count", "3");
+    QCommandLineOption kOption("k", "Constant of the Harris operator.", "value", "0.04");
+    QCommandLineOption percentageOption("percentage", "Percentage of points of the FRACTION selection.", "value", "0.01");
+    QCommandLineOption clusteringOption("clustering-percentage", "Percentage of points of the CLUSTERING selection, "
+                                        "the radius of the clusters is 1 - percentage of the diagonal.", "value", "0.99");
+    QCommandLineOption outputOption("output", "JSON file where the results are written, stdout if not given.", "file");
+    QCommandLineOption baselineOption("baseline", "JSON file of a previous run to compare with.", "file");
+    QCommandLineOption toleranceOption("tolerance", "Fraction a measure can be slower than the baseline "
+                                       "before it is a regression.", "value", "0.1");
+    parser.addOptions({meshesOption, sizesOption, ringsOption, threadsOption, repeatOption, kOption,
+                       percentageOption, clusteringOption, outputOption, baselineOption, toleranceOption});
+    parser.process(application);
+
+    BenchmarkOptions options;
+    options.meshes = parser.value(meshesOption).split(',', QString::SkipEmptyParts);
+    options.repetitions = parser.value(repeatOption).toInt();
+    options.k = parser.value(kOption).toDouble();
+    options.percentageOfPoints = parser.value(percentageOption).toDouble();
+    options.clusteringPercentage = parser.value(clusteringOption).toDouble();
+    double tolerance = parser.value(toleranceOption).toDouble();
+    if(!parseIntegers(parser.value(sizesOption), options.sizes) ||
+       !parseIntegers(parser.value(ringsOption), options.rings) ||
+       !parseIntegers(parser.value(threadsOption), options.threads) || options.repetitions <= 0)
+    {
+        err << "Sizes, rings, threads and repetitions must be positive integers" << endl;
+        return 2;
+    }
+    foreach(const QString & name, options.meshes)
+    {
+        if(!MeshGenerator::getNames().contains(name))
+        {
+            err << "Unknown mesh " << name << endl;
+            return 2;
+        }
+    }
+
+    //The baseline is read first, so that a wrong path does not waste a whole run
+    QJsonArray baseline;
+    if(parser.isSet(baselineOption))
+    {
+        QFile baselineFile(parser.value(baselineOption));
+        if(!baselineFile.open(QIODevice::ReadOnly))
+        {
+            err << "Could not read " << baselineFile.fileName() << endl;
+            return 2;
+        }
+        baseline = QJsonDocument::fromJson(baselineFile.readAll()).object()["results"].toArray();
+    }
+
+    Benchmark benchmark(options, &err);
+    QJsonArray results = benchmark.run();
+    if(results.isEmpty())
+    {
+        return 2;
+    }
+
+    QJsonObject document;
+    document["date"] = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
+    document["hardwareThreads"] = defaultThreadCount();
+    document["repetitions"] = options.repetitions;
+    document["k"] = options.k;
+    document["percentage"] = options.percentageOfPoints;
+    document["clusteringPercentage"] = options.clusteringPercentage;
+    document["results"] = results;
+    QByteArray json = QJsonDocument(document).toJson();
+    if(parser.isSet(outputOption))
+    {
+        QFile outputFile(parser.value(outputOption));
+        if(!outputFile.open(QIODevice::WriteOnly) || outputFile.write(json) != json.size())
+        {
+            err << "Could not write " << outputFile.fileName() << endl;
+            return 2;
+        }
+    }
+    else
+    {
+        QTextStream(stdout) << json;
+    }
+
+    if(parser.isSet(baselineOption))
+    {
+        return (Benchmark::compare(results, baseline, tolerance, err) > 0)? 1 : 0;
+    }
+    return 0;
+}
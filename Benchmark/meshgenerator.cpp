@@ -0,0 +1,318 @@
+#include "meshgenerator.h"
+#include <QFile>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <map>
+#include <random>
+#include <utility>
+
+/**
+ * @brief normalizeVertex Projects a point on the unit sphere
+ * @param coordinates The coordinates of the point, replaced by the projection
+ */
+static void normalizeVertex(double * coordinates)
+{
+    double length = sqrt(coordinates[0] * coordinates[0] + coordinates[1] * coordinates[1] +
+                         coordinates[2] * coordinates[2]);
+    coordinates[0] /= length;
+    coordinates[1] /= length;
+    coordinates[2] /= length;
+}
+
+/**
+ * @brief getNames
+ * @return the names of the meshes that generate accepts
+ */
+QStringList MeshGenerator::getNames()
+{
+    return QStringList() << "icosphere" << "torus" << "heightfield";
+}
+
+/**
+ * @brief generate builds a mesh with approximately a number of vertexes
+ * @param name "icosphere", "torus" or "heightfield"
+ * @param numVertexes the number of vertexes wanted, the mesh has the
+ *  closest number its shape allows
+ * @return the mesh, NULL if the name is not known
+ */
+Mesh * MeshGenerator::generate(const QString & name, int numVertexes)
+{
+    if(name == "icosphere")
+    {
+        int frequency = std::max(1, int(round(sqrt((numVertexes - 2) / 10.0))));
+        return generateIcosphere(frequency);
+    }
+    if(name == "torus")
+    {
+        //The segments around the tube are a third of the ones around the axis,
+        //so that the triangles are close to equilateral
+        int minorSegments = std::max(3, int(round(sqrt(numVertexes / 3.0))));
+        int majorSegments = std::max(3, int(round(double(numVertexes) / minorSegments)));
+        return generateTorus(majorSegments, minorSegments);
+    }
+    if(name == "heightfield")
+    {
+        int side = std::max(2, int(round(sqrt(double(numVertexes)))));
+        return generateHeightField(side, 0.002, 1);
+    }
+    return NULL;
+}
+
+/**
+ * @brief generateIcosphere builds a unit sphere by splitting every face of
+ *  an icosahedron in frequency * frequency triangles and projecting their
+ *  corners on the sphere
+ * @param frequency number of segments of every edge of the icosahedron
+ * @return the mesh, with 10 * frequency^2 + 2 vertexes
+ */
+Mesh * MeshGenerator::generateIcosphere(int frequency)
+{
+    const double t = (1.0 + sqrt(5.0)) / 2.0;
+    const double corners[12][3] = {
+        {-1, t, 0}, {1, t, 0}, {-1, -t, 0}, {1, -t, 0},
+        {0, -1, t}, {0, 1, t}, {0, -1, -t}, {0, 1, -t},
+        {t, 0, -1}, {t, 0, 1}, {-t, 0, -1}, {-t, 0, 1}};
+    const int faces[20][3] = {
+        {0, 11, 5}, {0, 5, 1}, {0, 1, 7}, {0, 7, 10}, {0, 10, 11},
+        {1, 5, 9}, {5, 11, 4}, {11, 10, 2}, {10, 7, 6}, {7, 1, 8},
+        {3, 9, 4}, {3, 4, 2}, {3, 2, 6}, {3, 6, 8}, {3, 8, 9},
+        {4, 9, 5}, {2, 4, 11}, {6, 2, 10}, {8, 6, 7}, {9, 8, 1}};
+    int n = frequency;
+    long long numVertexes = 10LL * n * n + 2;
+    long long numFaces = 20LL * n * n;
+
+    vector<double> coordinates;
+    vector<int> triangles;
+    coordinates.reserve(3 * numVertexes);
+    triangles.reserve(3 * numFaces);
+
+    auto addVertex = [&](const double * a, const double * b, const double * c, int i, int j)
+    {
+        //Point (i, j) of the grid of the face, with i steps towards b and j towards c
+        double point[3];
+        for(int axis = 0; axis < 3; axis++)
+        {
+            point[axis] = a[axis] + (b[axis] - a[axis]) * i / n + (c[axis] - a[axis]) * j / n;
+        }
+        normalizeVertex(point);
+        coordinates.insert(coordinates.end(), point, point + 3);
+        return int(coordinates.size() / 3 - 1);
+    };
+
+    for(int corner = 0; corner < 12; corner++)
+    {
+        addVertex(corners[corner], corners[corner], corners[corner], 0, 0);
+    }
+
+    //The n - 1 inner points of every edge are shared by its two faces, they are
+    //stored from the corner with the lowest index
+    std::map<std::pair<int, int>, int> edges;
+    auto getEdgePoint = [&](int from, int to, int step)
+    {
+        bool reversed = from > to;
+        std::pair<int, int> edge = reversed? std::make_pair(to, from) : std::make_pair(from, to);
+        auto found = edges.find(edge);
+        if(found == edges.end())
+        {
+            int first = coordinates.size() / 3;
+            for(int i = 1; i < n; i++)
+            {
+                addVertex(corners[edge.first], corners[edge.second], corners[edge.first], i, 0);
+            }
+            found = edges.insert(std::make_pair(edge, first)).first;
+        }
+        return found->second + (reversed? n - step : step) - 1;
+    };
+
+    vector<int> grid((n + 1) * (n + 1));
+    for(int face = 0; face < 20; face++)
+    {
+        int a = faces[face][0];
+        int b = faces[face][1];
+        int c = faces[face][2];
+        for(int i = 0; i <= n; i++)
+        {
+            for(int j = 0; i + j <= n; j++)
+            {
+                int index;
+                if(i == 0 && j == 0)
+                {
+                    index = a;
+                }
+                else if(i == n)
+                {
+                    index = b;
+                }
+                else if(j == n)
+                {
+                    index = c;
+                }
+                else if(j == 0)
+                {
+                    index = getEdgePoint(a, b, i);
+                }
+                else if(i == 0)
+                {
+                    index = getEdgePoint(a, c, j);
+                }
+                else if(i + j == n)
+                {
+                    index = getEdgePoint(b, c, j);
+                }
+                else
+                {
+                    index = addVertex(corners[a], corners[b], corners[c], i, j);
+                }
+                grid[i * (n + 1) + j] = index;
+            }
+        }
+
+        for(int i = 0; i < n; i++)
+        {
+            for(int j = 0; i + j < n; j++)
+            {
+                int corner = grid[i * (n + 1) + j];
+                int towardsB = grid[(i + 1) * (n + 1) + j];
+                int towardsC = grid[i * (n + 1) + j + 1];
+                triangles.insert(triangles.end(), {corner, towardsB, towardsC});
+                if(i + j < n - 1)
+                {
+                    int opposite = grid[(i + 1) * (n + 1) + j + 1];
+                    triangles.insert(triangles.end(), {towardsB, opposite, towardsC});
+                }
+            }
+        }
+    }
+
+    Mesh * mesh = new Mesh();
+    mesh->setData(coordinates, triangles);
+    return mesh;
+}
+
+/**
+ * @brief generateTorus builds a torus around the Z axis, with radii 1 and 0.35
+ * @param majorSegments number of segments around the Z axis
+ * @param minorSegments number of segments around the tube
+ * @return the mesh, with majorSegments * minorSegments vertexes
+ */
+Mesh * MeshGenerator::generateTorus(int majorSegments, int minorSegments)
+{
+    const double majorRadius = 1.0;
+    const double minorRadius = 0.35;
+    long long numVertexes = (long long)majorSegments * minorSegments;
+
+    vector<double> coordinates;
+    vector<int> triangles;
+    coordinates.reserve(3 * numVertexes);
+    triangles.reserve(6 * numVertexes);
+
+    for(int i = 0; i < majorSegments; i++)
+    {
+        double u = 2 * M_PI * i / majorSegments;
+        for(int j = 0; j < minorSegments; j++)
+        {
+            double v = 2 * M_PI * j / minorSegments;
+            double radius = majorRadius + minorRadius * cos(v);
+            coordinates.insert(coordinates.end(), {radius * cos(u), radius * sin(u), minorRadius * sin(v)});
+        }
+    }
+
+    for(int i = 0; i < majorSegments; i++)
+    {
+        int nextI = (i + 1) % majorSegments;
+        for(int j = 0; j < minorSegments; j++)
+        {
+            int nextJ = (j + 1) % minorSegments;
+            int p00 = i * minorSegments + j;
+            int p10 = nextI * minorSegments + j;
+            int p01 = i * minorSegments + nextJ;
+            int p11 = nextI * minorSegments + nextJ;
+            triangles.insert(triangles.end(), {p00, p10, p11, p00, p11, p01});
+        }
+    }
+
+    Mesh * mesh = new Mesh();
+    mesh->setData(coordinates, triangles);
+    return mesh;
+}
+
+/**
+ * @brief generateHeightField builds a square grid of side 1 whose height
+ *  is a sum of waves plus uniform noise
+ * @param side number of vertexes of every side of the grid
+ * @param noise amplitude of the noise
+ * @param seed seed of the noise
+ * @return the mesh, with side * side vertexes
+ */
+Mesh * MeshGenerator::generateHeightField(int side, double noise, unsigned int seed)
+{
+    long long numVertexes = (long long)side * side;
+    std::mt19937 generator(seed);
+    std::uniform_real_distribution<double> distribution(-noise, noise);
+
+    vector<double> coordinates;
+    vector<int> triangles;
+    coordinates.reserve(3 * numVertexes);
+    triangles.reserve(6 * numVertexes);
+
+    for(int i = 0; i < side; i++)
+    {
+        double y = double(i) / (side - 1);
+        for(int j = 0; j < side; j++)
+        {
+            double x = double(j) / (side - 1);
+            double z = 0.05 * sin(6 * M_PI * x) * cos(4 * M_PI * y) + 0.02 * sin(14 * M_PI * (x + y));
+            coordinates.insert(coordinates.end(), {x, y, z + distribution(generator)});
+        }
+    }
+
+    for(int i = 0; i + 1 < side; i++)
+    {
+        for(int j = 0; j + 1 < side; j++)
+        {
+            int p00 = i * side + j;
+            int p01 = p00 + 1;
+            int p10 = p00 + side;
+            int p11 = p10 + 1;
+            triangles.insert(triangles.end(), {p00, p01, p11, p00, p11, p10});
+        }
+    }
+
+    Mesh * mesh = new Mesh();
+    mesh->setData(coordinates, triangles);
+    return mesh;
+}
+
+/**
+ * @brief writeOFF writes a mesh as an OFF file, with 9 significant digits
+ * @param mesh the mesh
+ * @param fileName the path of the file
+ * @return false if the file could not be written
+ */
+bool MeshGenerator::writeOFF(Mesh * mesh, const QString & fileName)
+{
+    FILE * file = fopen(QFile::encodeName(fileName).constData(), "w");
+    if(file == NULL)
+    {
+        return false;
+    }
+
+    int numVertexes = mesh->getNumVertexes();
+    int numFaces = mesh->getNumFaces();
+    const double * coordinates = mesh->getCoordinates();
+    const int * triangles = mesh->getTriangles();
+
+    fprintf(file, "OFF\n%d %d 0\n", numVertexes, numFaces);
+    for(int i = 0; i < numVertexes; i++)
+    {
+        fprintf(file, "%.9g %.9g %.9g\n", coordinates[3 * i], coordinates[3 * i + 1], coordinates[3 * i + 2]);
+    }
+    for(int i = 0; i < numFaces; i++)
+    {
+        fprintf(file, "3 %d %d %d\n", triangles[3 * i], triangles[3 * i + 1], triangles[3 * i + 2]);
+    }
+
+    bool written = !ferror(file);
+    return (fclose(file) == 0) && written;
+}
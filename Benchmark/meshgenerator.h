@@ -0,0 +1,67 @@
+#ifndef MESHGENERATOR_H
+#define MESHGENERATOR_H
+
+#include "BasicStructures/mesh.h"
+#include <QString>
+#include <QStringList>
+
+/**
+ * @brief The MeshGenerator class builds parametric meshes of any size, so
+ *  that the benchmark does not depend on mesh files. Every mesh is
+ *  deterministic: the same parameters always give the same mesh.
+ */
+class MeshGenerator
+{
+public:
+    /**
+     * @brief getNames
+     * @return the names of the meshes that generate accepts
+     */
+    static QStringList getNames();
+
+    /**
+     * @brief generate builds a mesh with approximately a number of vertexes
+     * @param name "icosphere", "torus" or "heightfield"
+     * @param numVertexes the number of vertexes wanted, the mesh has the
+     *  closest number its shape allows
+     * @return the mesh, NULL if the name is not known
+     */
+    static Mesh * generate(const QString & name, int numVertexes);
+
+    /**
+     * @brief generateIcosphere builds a unit sphere by splitting every face of
+     *  an icosahedron in frequency * frequency triangles and projecting their
+     *  corners on the sphere
+     * @param frequency number of segments of every edge of the icosahedron
+     * @return the mesh, with 10 * frequency^2 + 2 vertexes
+     */
+    static Mesh * generateIcosphere(int frequency);
+
+    /**
+     * @brief generateTorus builds a torus around the Z axis, with radii 1 and 0.35
+     * @param majorSegments number of segments around the Z axis
+     * @param minorSegments number of segments around the tube
+     * @return the mesh, with majorSegments * minorSegments vertexes
+     */
+    static Mesh * generateTorus(int majorSegments, int minorSegments);
+
+    /**
+     * @brief generateHeightField builds a square grid of side 1 whose height
+     *  is a sum of waves plus uniform noise
+     * @param side number of vertexes of every side of the grid
+     * @param noise amplitude of the noise
+     * @param seed seed of the noise
+     * @return the mesh, with side * side vertexes
+     */
+    static Mesh * generateHeightField(int side, double noise, unsigned int seed);
+
+    /**
+     * @brief writeOFF writes a mesh as an OFF file, with 9 significant digits
+     * @param mesh the mesh
+     * @param fileName the path of the file
+     * @return false if the file could not be written
+     */
+    static bool writeOFF(Mesh * mesh, const QString & fileName);
+};
+
+#endif // MESHGENERATOR_H
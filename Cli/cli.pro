@@ -0,0 +1,17 @@
+QT = core
+CONFIG += c++11 console thread
+CONFIG -= app_bundle
+TARGET = interestpoints
+
+DEFINES += QT_DEPRECATED_WARNINGS
+
+# BasicStructures, FileManager and Engine, without the GUI
+include(../core.pri)
+
+SOURCES += \
+        main.cpp
+
+# Default rules for deployment.
+qnx: target.path = /tmp/$${TARGET}/bin
+else: unix:!android: target.path = /opt/$${TARGET}/bin
+!isEmpty(target.path): INSTALLS += target
@@ -0,0 +1,273 @@
+#include "BasicStructures/mesh.h"
+#include "Engine/engine.h"
+#include "FileManager/compressedstream.h"
+#include "FileManager/filemanager.h"
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QTextStream>
+
+/**
+ * @brief readMesh Reads a mesh with the reader of the extension of its file
+ * @param manager The FileManager used to read the files
+ * @param fileName The path given for the mesh. For TRI and VERT meshes it may
+ *  be either of them, the other one is next to it with the same base name.
+ * @param useCache true to read the binary cache of the mesh if it is valid,
+ *  and to write it after parsing the files otherwise
+ * @return The mesh, NULL if it could not be read
+ */
+static Mesh * readMesh(FileManager & manager, const QString & fileName, bool useCache)
+{
+    MeshType type;
+    QString file1, file2;
+    if(!FileManager::detectMeshType(fileName, type, file1, file2))
+    {
+        return NULL;
+    }
+
+    bool fromCache = false;
+    Mesh * mesh = manager.readMesh(type, file1, file2, useCache, &fromCache);
+    //Failing to write the cache (e.g. a read-only folder) is not an error
+    if(mesh != NULL && useCache && !fromCache)
+    {
+        QStringList sources = FileManager::getSourceFiles(type, file1, file2);
+        manager.writeMeshCache(mesh, FileManager::getCacheFileName(sources[0]), sources);
+    }
+    return mesh;
+}
+
+/**
+ * @brief getOutputName Name of the file where --output-dir writes the interest
+ *  points of a mesh: its file name without the compression, plus ".txt". The
+ *  extension is kept, so that e.g. part.off and part.ply do not share it.
+ * @param fileName The path of the mesh
+ * @return The name of the file, without folder
+ */
+static QString getOutputName(const QString & fileName)
+{
+    return QFileInfo(CompressedStream::getUncompressedName(fileName)).fileName() + ".txt";
+}
+
+/**
+ * @brief readList Reads the paths of a batch list, one per line. Empty lines
+ *  and lines starting with '#' are skipped.
+ * @param listFileName The path of the list, "-" for the standard input
+ * @param fileNames The list where the paths are added
+ * @return false if the list could not be read
+ */
+static bool readList(const QString & listFileName, QStringList & fileNames)
+{
+    QFile listFile(listFileName);
+    bool opened;
+    if(listFileName == "-")
+    {
+        opened = listFile.open(stdin, QIODevice::ReadOnly | QIODevice::Text);
+    }
+    else
+    {
+        opened = listFile.open(QIODevice::ReadOnly | QIODevice::Text);
+    }
+    if(!opened)
+    {
+        return false;
+    }
+
+    QTextStream in(&listFile);
+    while(!in.atEnd())
+    {
+        QString line = in.readLine().trimmed();
+        if(!line.isEmpty() && !line.startsWith('#'))
+        {
+            fileNames << line;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief writeInterestPoints Writes the interest points of a mesh, after a
+ *  line "# <mesh> <number of points>", as one line "<index> <x> <y> <z>" per point
+ * @param out The stream
+ * @param fileName The path of the mesh
+ * @param mesh The mesh
+ * @param interestPoints The indexes of the interest points
+ */
+static void writeInterestPoints(QTextStream & out, const QString & fileName, Mesh * mesh,
+                                const vector<int> & interestPoints)
+{
+    const double * coordinates = mesh->getCoordinates();
+    out << "# " << fileName << " " << int(interestPoints.size()) << "\n";
+    for(int index : interestPoints)
+    {
+        out << index << " " << QString::number(coordinates[3 * index], 'g', 9)
+            << " " << QString::number(coordinates[3 * index + 1], 'g', 9)
+            << " " << QString::number(coordinates[3 * index + 2], 'g', 9) << "\n";
+    }
+    out.flush();
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication application(argc, argv);
+    QCoreApplication::setApplicationName("interestpoints");
+    QTextStream err(stderr);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(
+        "Finds the interest points of meshes (OFF, PLY, STL, or TRI and VERT; OFF, TRI and "
+        "VERT files may be compressed) without a display. For every mesh, writes a line \"# <mesh> <count>\" "
+        "followed by one line \"<index> <x> <y> <z>\" per interest point.");
+    parser.addHelpOption();
+    parser.addPositionalArgument("meshes", "Mesh files. For TRI and VERT meshes, either of the files.",
+                                 "[meshes...]");
+    QCommandLineOption listOption("list", "File with one mesh per line, - for the standard input.", "file");
+    QCommandLineOption ringsOption("rings", "Number of rings of the neighbourhoods.", "count", "3");
+    QCommandLineOption kOption("k", "Constant of the Harris operator.", "value", "0.2");
+    QCommandLineOption percentageOption("percentage", "Percentage of points to select.", "value", "0.5");
+    QCommandLineOption modeOption("mode", "Selection mode: fraction or clustering.", "mode", "fraction");
+    QCommandLineOption threadsOption("threads", "Number of threads, all the hardware threads if 0.", "count", "0");
+    QCommandLineOption outputOption("output", "File where the interest points are written, stdout if not given.",
+                                    "file");
+    QCommandLineOption outputDirOption("output-dir", "Folder where the interest points of every mesh are "
+                                       "written, to <mesh file name>.txt.", "folder");
+    QCommandLineOption cacheOption("cache", "Read the binary cache of the meshes if valid, write it otherwise.");
+    parser.addOptions({listOption, ringsOption, kOption, percentageOption, modeOption, threadsOption,
+                       outputOption, outputDirOption, cacheOption});
+    parser.process(application);
+
+    QStringList fileNames = parser.positionalArguments();
+    if(parser.isSet(listOption) && !readList(parser.value(listOption), fileNames))
+    {
+        err << "Could not read " << parser.value(listOption) << endl;
+        return 2;
+    }
+    if(fileNames.isEmpty())
+    {
+        err << "No mesh given" << endl;
+        parser.showHelp(2);
+    }
+
+    bool ringsOk, kOk, percentageOk, threadsOk;
+    int numRings = parser.value(ringsOption).toInt(&ringsOk);
+    double k = parser.value(kOption).toDouble(&kOk);
+    double percentageOfPoints = parser.value(percentageOption).toDouble(&percentageOk);
+    int numThreads = parser.value(threadsOption).toInt(&threadsOk);
+    QString mode = parser.value(modeOption).toLower();
+    if(!ringsOk || numRings <= 0 || !kOk || k < 0 || !threadsOk)
+    {
+        err << "The number of rings should be a positive integer and k a non negative number" << endl;
+        return 2;
+    }
+    if(!percentageOk || percentageOfPoints <= 0 || percentageOfPoints > 1)
+    {
+        err << "The percentage of interest points to select should be greater than 0 "
+               "and lower or equals to 1" << endl;
+        return 2;
+    }
+    if(mode != "fraction" && mode != "clustering")
+    {
+        err << "Unknown selection mode " << mode << endl;
+        return 2;
+    }
+    SelectionMode selectionMode = (mode == "clustering")? SelectionMode::CLUSTERING : SelectionMode::FRACTION;
+    if(parser.isSet(outputOption) && parser.isSet(outputDirOption))
+    {
+        err << "Only one of --output and --output-dir can be given" << endl;
+        return 2;
+    }
+
+    QFile outputFile(parser.value(outputOption));
+    bool outputOpened;
+    if(parser.isSet(outputOption))
+    {
+        outputOpened = outputFile.open(QIODevice::WriteOnly | QIODevice::Text);
+    }
+    else
+    {
+        outputOpened = outputFile.open(stdout, QIODevice::WriteOnly | QIODevice::Text);
+    }
+    if(!outputOpened)
+    {
+        err << "Could not write " << parser.value(outputOption) << endl;
+        return 2;
+    }
+    QTextStream out(&outputFile);
+    QDir outputDir(parser.value(outputDirOption));
+    if(parser.isSet(outputDirOption))
+    {
+        //Meshes with the same file name in different folders would overwrite
+        //each other's results, so the batch does not start
+        QHash<QString, QString> outputSources;
+        foreach(const QString & fileName, fileNames)
+        {
+            QString outputName = getOutputName(fileName);
+            if(outputSources.contains(outputName))
+            {
+                err << outputSources.value(outputName) << " and " << fileName << " would both be written to "
+                    << outputDir.filePath(outputName) << endl;
+                return 2;
+            }
+            outputSources.insert(outputName, fileName);
+        }
+        if(!QDir().mkpath(outputDir.path()))
+        {
+            err << "Could not create " << outputDir.path() << endl;
+            return 2;
+        }
+    }
+
+    FileManager manager;
+    manager.setNumThreads(numThreads);
+    Engine engine;
+    engine.setNumThreads(numThreads);
+
+    //A mesh that fails does not stop the batch, but the exit code reports it
+    int numFailed = 0;
+    foreach(const QString & fileName, fileNames)
+    {
+        Mesh * mesh = readMesh(manager, fileName, parser.isSet(cacheOption));
+        if(mesh == NULL)
+        {
+            err << "Could not read " << fileName << endl;
+            numFailed++;
+            continue;
+        }
+
+        vector<int> * interestPoints =
+            engine.findInterestPoints(mesh, numRings, k, percentageOfPoints, selectionMode);
+        //Only frees the coefficients of this mesh before reading the next one
+        engine.clearCoefficients();
+
+        if(parser.isSet(outputDirOption))
+        {
+            QFile meshOutputFile(outputDir.filePath(getOutputName(fileName)));
+            if(!meshOutputFile.open(QIODevice::WriteOnly | QIODevice::Text))
+            {
+                err << "Could not write " << meshOutputFile.fileName() << endl;
+                numFailed++;
+            }
+            else
+            {
+                QTextStream meshOut(&meshOutputFile);
+                writeInterestPoints(meshOut, fileName, mesh, *interestPoints);
+            }
+        }
+        else
+        {
+            writeInterestPoints(out, fileName, mesh, *interestPoints);
+        }
+
+        delete interestPoints;
+        delete mesh;
+    }
+
+    if(numFailed > 0)
+    {
+        err << numFailed << " of " << fileNames.size() << " meshes failed" << endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,108 @@
+#include "Communicator/backgroundjob.h"
+
+/**
+ * @brief BackgroundJob::BackgroundJob creates a job that has not started.
+ * @param progressCallback function called from the worker threads when the
+ *  progress grows by at least 1%, it may be empty.
+ */
+BackgroundJob::BackgroundJob(const std::function<void(double)> & progressCallback)
+    : finished(false)
+{
+    control.setProgressCallback(progressCallback);
+}
+
+/**
+ * @brief BackgroundJob::~BackgroundJob cancels the job if it is still running
+ *  and waits for its thread.
+ */
+BackgroundJob::~BackgroundJob()
+{
+    stop();
+}
+
+/**
+ * @brief BackgroundJob::start runs the task on a new thread, it must be called
+ *  once from the constructor of the subclass.
+ * @param run the task, which receives the control of the job.
+ */
+void BackgroundJob::start(const std::function<void(JobControl *)> & run)
+{
+    worker = std::thread([this, run]()
+    {
+        try
+        {
+            run(&control);
+        }
+        catch (...)
+        {
+            error = std::current_exception();
+        }
+        finished = true;
+    });
+}
+
+/**
+ * @brief BackgroundJob::stop cancels the task if it is still running and waits
+ *  for its thread. Subclasses call it from their destructor before releasing
+ *  what the task writes to.
+ */
+void BackgroundJob::stop()
+{
+    control.cancel();
+    if (worker.joinable())
+    {
+        worker.join();
+    }
+}
+
+/**
+ * @brief BackgroundJob::isFinished
+ * @return true if the task has ended, successfully or not.
+ */
+bool BackgroundJob::isFinished()
+{
+    return finished;
+}
+
+/**
+ * @brief BackgroundJob::getProgress
+ * @return the fraction of the current stage of the task done, from 0 to 1.
+ */
+double BackgroundJob::getProgress()
+{
+    return finished? 1.0 : control.getProgress();
+}
+
+/**
+ * @brief BackgroundJob::cancel asks the task to stop. wait will then throw an
+ *  Exception of type JOB_CANCELLED, unless it had already finished.
+ */
+void BackgroundJob::cancel()
+{
+    control.cancel();
+}
+
+/**
+ * @brief BackgroundJob::isCancelled
+ * @return true if cancel has been called.
+ */
+bool BackgroundJob::isCancelled()
+{
+    return control.isCancelled();
+}
+
+/**
+ * @brief BackgroundJob::wait waits until the task ends.
+ * @throw the exception thrown by the task, if any.
+ */
+void BackgroundJob::wait()
+{
+    if (worker.joinable())
+    {
+        worker.join();
+    }
+    if (error)
+    {
+        std::rethrow_exception(error);
+    }
+}
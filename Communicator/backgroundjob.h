@@ -0,0 +1,85 @@
+#ifndef BACKGROUNDJOB_H
+#define BACKGROUNDJOB_H
+
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <thread>
+#include "Engine/jobcontrol.h"
+
+/**
+ * @brief The BackgroundJob class is the handle of a task of the Communicator
+ *  running on its own thread. The owner polls it (or receives progress
+ *  callbacks), may cancel it, and waits for it once finished. Subclasses
+ *  keep the result of the task.
+ */
+class BackgroundJob
+{
+private:
+    std::thread worker;
+    std::atomic<bool> finished;
+    std::exception_ptr error;
+
+protected:
+    JobControl control;
+
+    /**
+     * @brief start runs the task on a new thread, it must be called once from
+     *  the constructor of the subclass.
+     * @param run the task, which receives the control of the job.
+     */
+    void start(const std::function<void(JobControl *)> & run);
+
+    /**
+     * @brief stop cancels the task if it is still running and waits for its
+     *  thread. Subclasses call it from their destructor before releasing
+     *  what the task writes to.
+     */
+    void stop();
+
+public:
+    /**
+     * @brief BackgroundJob creates a job that has not started.
+     * @param progressCallback function called from the worker threads when
+     *  the progress grows by at least 1%, it may be empty.
+     */
+    BackgroundJob(const std::function<void(double)> & progressCallback);
+
+    /**
+     * @brief ~BackgroundJob cancels the job if it is still running and waits
+     *  for its thread.
+     */
+    virtual ~BackgroundJob();
+
+    /**
+     * @brief isFinished
+     * @return true if the task has ended, successfully or not.
+     */
+    bool isFinished();
+
+    /**
+     * @brief getProgress
+     * @return the fraction of the current stage of the task done, from 0 to 1.
+     */
+    double getProgress();
+
+    /**
+     * @brief cancel asks the task to stop. wait will then throw an Exception
+     *  of type JOB_CANCELLED, unless it had already finished.
+     */
+    void cancel();
+
+    /**
+     * @brief isCancelled
+     * @return true if cancel has been called.
+     */
+    bool isCancelled();
+
+    /**
+     * @brief wait waits until the task ends.
+     * @throw the exception thrown by the task, if any.
+     */
+    void wait();
+};
+
+#endif // BACKGROUNDJOB_H
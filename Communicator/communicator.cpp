@@ -3,46 +3,115 @@
 #include "FileManager/filemanager.h"
 #include <string>
 #include <QDebug>
+#include <QStringList>
 
 using std::string;
 
 Mesh * Communicator::mesh = NULL;
+quint64 Communicator::meshHash = 0;
+unsigned long long Communicator::meshHashRevision = 0;
 
 Communicator::Communicator()
 {
-
+    engine = NULL;
+    resultCacheEnabled = true;
 }
 
 /**
  * @brief Communicator::loadMesh uses the FileManager to load a mesh, reading
- *  the tri, vert OR off files.
+ *  the tri, vert, off, ply OR stl files.
  */
 void Communicator::loadMesh(MeshType type, QString file1, QString file2)
 {
     FileManager manager;
+    QStringList sources = FileManager::getSourceFiles(type, file1, file2);
+    if (!readMesh(manager, type, file1, file2))
+    {
+        // Failing to write the cache (e.g. a read-only folder) is not an error
+        manager.writeMeshCache(
+            mesh, FileManager::getCacheFileName(sources[0]), sources);
+    }
+}
+
+/**
+ * @brief Communicator::startLoadMesh loads a mesh on a new thread, as
+ *  loadMesh does. The progress is the part of the files read. The mesh can
+ *  be used for rendering as soon as the files are read, while its adjacency
+ *  and its cache are written, but no other call can be made to the
+ *  Communicator until the job finishes.
+ * @param type the type of the mesh files.
+ * @param file1 the first file, the tri file for TRIVERT meshes.
+ * @param file2 the vert file for TRIVERT meshes.
+ * @param meshReadCallback optional function called from the worker thread
+ *  with the mesh as soon as it is read, to prepare its rendering.
+ * @param progressCallback optional function called from the worker threads
+ *  every time the progress grows by at least 1%.
+ * @return the handle of the job, owned by the caller. Deleting it cancels
+ *  the job.
+ */
+MeshLoadingJob * Communicator::startLoadMesh(
+    MeshType type, QString file1, QString file2,
+    const std::function<void(Mesh *)> & meshReadCallback,
+    const std::function<void(double)> & progressCallback)
+{
+    QStringList sources = FileManager::getSourceFiles(type, file1, file2);
+    return new MeshLoadingJob([=](JobControl * control)
+    {
+        FileManager manager;
+        manager.setJobControl(control);
+        bool mustComplete =
+            !this->readMesh(manager, type, file1, file2);
+        if (meshReadCallback)
+        {
+            meshReadCallback(mesh);
+        }
+        return mustComplete;
+    }, [=](JobControl *)
+    {
+        // The cache builds the adjacency, which the Engine would otherwise
+        // build in the first calculation
+        FileManager manager;
+        manager.writeMeshCache(
+            mesh, FileManager::getCacheFileName(sources[0]), sources);
+    }, progressCallback);
+}
+
+/**
+ * @brief Communicator::readMesh replaces the mesh with the one read from its
+ *  binary cache, if valid, or from its files.
+ * @param manager the FileManager used to read the files.
+ * @param type the type of the mesh files.
+ * @param file1 the first file, the tri file for TRIVERT meshes.
+ * @param file2 the vert file for TRIVERT meshes.
+ * @return true if the mesh was read from its cache.
+ */
+bool Communicator::readMesh(FileManager & manager, MeshType type,
+                            QString file1, QString file2)
+{
     delete mesh;
     mesh = 0;
-    if (type == MeshType::TRIVERT)
+
+    // A valid binary cache next to the source files is loaded instead of
+    // parsing them, and it is written after parsing them otherwise.
+    bool fromCache = false;
+    mesh = manager.readMesh(type, file1, file2, true, &fromCache);
+    if (fromCache)
     {
-        QFile * triFile = new QFile(file1);
-        QFile * vertFile = new QFile(file2);
-        mesh = manager.readTriVert(triFile, vertFile);
-        delete triFile;
-        delete vertFile;
+        return true;
     }
-    else if (type == MeshType::OFF)
+
+    if (mesh == NULL && manager.isCancelled())
     {
-        QFile * off = new QFile(file1);
-        mesh = manager.readOFF(off);
-        delete off;
+        string messge = "The loading of the mesh was cancelled.";
+        throw Exception(ExceptionType::JOB_CANCELLED, messge);
     }
-
     if (mesh == NULL)
     {
         string messge =
             "Error while building mesh. Check that your mesh files are not corrupted";
         throw Exception(ExceptionType::ERROR_WHILE_READING, messge);
     }
+    return false;
 }
 
 /**
@@ -81,7 +150,7 @@ void Communicator::bindEngine(Engine * engine)
  *  selected after calculation.
  * @return The calculated interest points.
  */
-vector<Vertex *> * Communicator::retrieveInterestPoints(
+vector<Vertex> * Communicator::retrieveInterestPoints(
     int numRings, double k, double percentageOfPoints, QString selectionMode)
 {
     SelectionMode mode;
@@ -102,13 +171,129 @@ vector<Vertex *> * Communicator::retrieveInterestPoints(
         throw Exception(ExceptionType::UNKNOWN_SEL_METHOD, messge);
     }
 
+    // A query already answered for the same mesh is read from the cache
+    ResultCacheHeader key;
+    if (resultCacheEnabled)
+    {
+        if (meshHashRevision != mesh->getRevision())
+        {
+            meshHash = ResultCache::hashMesh(mesh);
+            meshHashRevision = mesh->getRevision();
+        }
+        key = ResultCache::makeKey(
+            meshHash, mesh, numRings, k, percentageOfPoints, mode);
+        vector<int> * indexes = new vector<int>();
+        if (resultCache.read(key, harrisValues, *indexes))
+        {
+            return convertIntPoints(indexes);
+        }
+        delete indexes;
+    }
+
+    harrisValues = engine->computeHarrisResponses(this->mesh, numRings, k);
+    if (engine->isCancelled())
+    {
+        string messge =
+            "The calculation of the interest points was cancelled.";
+        throw Exception(ExceptionType::JOB_CANCELLED, messge);
+    }
     vector<int> * indexes =
-        engine->findInterestPoints(
-            this->mesh, numRings, k, percentageOfPoints, mode);
+        engine->selectInterestPoints(
+            this->mesh, harrisValues, percentageOfPoints, mode);
+
+    if (resultCacheEnabled)
+    {
+        // Failing to write the cache (e.g. no cache folder) is not an error
+        resultCache.write(key, harrisValues, *indexes);
+    }
 
     return convertIntPoints(indexes);
 }
 
+/**
+ * @brief Communicator::startInterestPoints calculates the interest points of
+ *  the mesh on a new thread, as retrieveInterestPoints does. Only one job can
+ *  run at a time, and the mesh must not be loaded again while it runs.
+ * @param numRings the number of ring to consider during the interest
+ *  points calculation.
+ * @param k the harris param.
+ * @param percentageOfPoints the percentage of interest points to select.
+ * @param selectionMode Indicates the way the interest points will be
+ *  selected after calculation.
+ * @param progressCallback optional function called from the worker threads
+ *  every time the progress grows by at least 1%.
+ * @return the handle of the job, owned by the caller. Deleting it cancels
+ *  the job.
+ */
+InterestPointsJob * Communicator::startInterestPoints(
+    int numRings, double k, double percentageOfPoints, QString selectionMode,
+    const std::function<void(double)> & progressCallback)
+{
+    this->healthCheck();
+
+    // The Engine checks the control of the job inside its per-vertex loop
+    return new InterestPointsJob([=](JobControl * control)
+    {
+        engine->setJobControl(control);
+        try
+        {
+            vector<Vertex> * interestPoints = this->retrieveInterestPoints(
+                numRings, k, percentageOfPoints, selectionMode);
+            engine->setJobControl(NULL);
+            return interestPoints;
+        }
+        catch (...)
+        {
+            engine->setJobControl(NULL);
+            throw;
+        }
+    }, progressCallback);
+}
+
+/**
+ * @brief Communicator::getHarrisValues returns the Harris response of every
+ *  vertex of the mesh, as calculated in the last call to
+ *  retrieveInterestPoints.
+ * @return a vector with one value per vertex.
+ */
+const VectorXd & Communicator::getHarrisValues()
+{
+    return harrisValues;
+}
+
+/**
+ * @brief Communicator::setResultCacheEnabled defines whether
+ *  retrieveInterestPoints looks up and stores its results in the on-disk
+ *  result cache.
+ * @param enabled true to use the cache, which is the default.
+ */
+void Communicator::setResultCacheEnabled(bool enabled)
+{
+    resultCacheEnabled = enabled;
+}
+
+/**
+ * @brief Communicator::setResultCacheDirectory changes the folder of the
+ *  result cache, "results" in the cache folder of the user by default.
+ * @param directory the folder, created when the first result is stored.
+ */
+void Communicator::setResultCacheDirectory(QString directory)
+{
+    qint64 maxSize = resultCache.getMaxSize();
+    resultCache = ResultCache(directory);
+    resultCache.setMaxSize(maxSize);
+}
+
+/**
+ * @brief Communicator::setResultCacheMaxSize sets the bytes the files of the
+ *  result cache can take before the least recently used ones are removed.
+ * @param maxSize the size, RESULT_CACHE_DEFAULT_MAX_SIZE by default.
+ */
+void Communicator::setResultCacheMaxSize(qint64 maxSize)
+{
+    resultCache.setMaxSize(maxSize);
+}
+
 /**
  * @brief Communicator::healthCheck Checks wether the engine has been binded
  *  and the mesh has been loaded, prior to start the calculation of the
@@ -130,13 +315,13 @@ void Communicator::healthCheck()
  * @param indexes The indexes of the vertexes to retrieve.
  * @return a vector with the vertexes.
  */
-vector<Vertex *> * Communicator::convertIntPoints(vector<int>* indexes)
+vector<Vertex> * Communicator::convertIntPoints(vector<int>* indexes)
 {
-    vector<Vertex *> * vtx = new vector<Vertex *>();
+    vector<Vertex> * vtx = new vector<Vertex>();
 
-    for (int i = 0; i < indexes->size(); i++)
+    for (unsigned int i = 0; i < indexes->size(); i++)
     {
-        vtx->push_back(mesh->getAllVertexes()->at(indexes->at(i)));
+        vtx->push_back(mesh->getVertex(indexes->at(i)));
     }
 
     delete indexes;
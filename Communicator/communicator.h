@@ -2,10 +2,14 @@
 #define COMMUNICATOR_H
 
 #include <QString>
+#include <QStringList>
 #include "BasicStructures/mesh.h"
 #include "Engine/engine.h"
-
-enum MeshType {TRIVERT, OFF};
+#include "Communicator/interestpointsjob.h"
+#include "Communicator/meshloadingjob.h"
+#include "Communicator/resultcache.h"
+#include "FileManager/filemanager.h"
+#include <functional>
 
 /**
  * @brief The Communicator class intermediates between the Engine and the UI.
@@ -17,23 +21,66 @@ private:
     // mesh during the whole execution of the program.
     static Mesh * mesh;
 
+    // Hash of the coordinates and faces of the mesh, computed the first time
+    // a result is looked up in the cache for every revision of the mesh.
+    static quint64 meshHash;
+    static unsigned long long meshHashRevision;
+
     Engine * engine;
 
+    ResultCache resultCache;
+    bool resultCacheEnabled;
+
+    // Harris response of every vertex in the last query.
+    VectorXd harrisValues;
+
     /**
      * @brief healthCheck Checks wether the engine has been binded and the mesh
      *  has been loaded, prior to start the calculation of the interest points.
      */
     void healthCheck();
 
+    /**
+     * @brief readMesh replaces the mesh with the one read from its binary
+     *  cache, if valid, or from its files.
+     * @param manager the FileManager used to read the files.
+     * @param type the type of the mesh files.
+     * @param file1 the first file, the tri file for TRIVERT meshes.
+     * @param file2 the vert file for TRIVERT meshes.
+     * @return true if the mesh was read from its cache.
+     */
+    bool readMesh(FileManager & manager, MeshType type, QString file1, QString file2);
+
 public:
     Communicator();
 
     /**
-     * @brief uses the FileManager to load a mesh, reading the tri, vert OR off
-     * files.
+     * @brief uses the FileManager to load a mesh, reading the tri, vert, off,
+     * ply OR stl files.
      */
     void loadMesh(MeshType, QString, QString);
 
+    /**
+     * @brief startLoadMesh loads a mesh on a new thread, as loadMesh does.
+     *  The progress is the part of the files read. The mesh can be used for
+     *  rendering as soon as the files are read, while its adjacency and its
+     *  cache are written, but no other call can be made to the Communicator
+     *  until the job finishes.
+     * @param type the type of the mesh files.
+     * @param file1 the first file, the tri file for TRIVERT meshes.
+     * @param file2 the vert file for TRIVERT meshes.
+     * @param meshReadCallback optional function called from the worker
+     *  thread with the mesh as soon as it is read, to prepare its rendering.
+     * @param progressCallback optional function called from the worker
+     *  threads every time the progress grows by at least 1%.
+     * @return the handle of the job, owned by the caller. Deleting it cancels
+     *  the job.
+     */
+    MeshLoadingJob * startLoadMesh(
+        MeshType type, QString file1, QString file2,
+        const std::function<void(Mesh *)> & meshReadCallback = std::function<void(Mesh *)>(),
+        const std::function<void(double)> & progressCallback = std::function<void(double)>());
+
     /**
      * @brief getMesh returns a pointer to the mesh.
      * @return a poiner to mesh
@@ -56,18 +103,66 @@ public:
      * @param percentageOfPoints the percentage of interest points to select.
      * @param selectionMode Indicates the way the interest points will be
      *  selected after calculation.
-     * @return The calculated interest points.
+     * @return The calculated interest points, as views of the vertexes of
+     *  the mesh.
      */
-    vector<Vertex *> * retrieveInterestPoints(
+    vector<Vertex> * retrieveInterestPoints(
         int numRings, double k, double percentageOfPoints, QString selectionMode);
 
+    /**
+     * @brief startInterestPoints calculates the interest points of the mesh
+     *  on a new thread, as retrieveInterestPoints does. Only one job can run
+     *  at a time, and the mesh must not be loaded again while it runs.
+     * @param numRings the number of ring to consider during the interest
+     *  points calculation.
+     * @param k the harris param.
+     * @param percentageOfPoints the percentage of interest points to select.
+     * @param selectionMode Indicates the way the interest points will be
+     *  selected after calculation.
+     * @param progressCallback optional function called from the worker
+     *  threads every time the progress grows by at least 1%.
+     * @return the handle of the job, owned by the caller. Deleting it cancels
+     *  the job.
+     */
+    InterestPointsJob * startInterestPoints(
+        int numRings, double k, double percentageOfPoints, QString selectionMode,
+        const std::function<void(double)> & progressCallback = std::function<void(double)>());
+
+    /**
+     * @brief getHarrisValues returns the Harris response of every vertex of
+     *  the mesh, as calculated in the last call to retrieveInterestPoints.
+     * @return a vector with one value per vertex.
+     */
+    const VectorXd & getHarrisValues();
+
+    /**
+     * @brief setResultCacheEnabled defines whether retrieveInterestPoints
+     *  looks up and stores its results in the on-disk result cache.
+     * @param enabled true to use the cache, which is the default.
+     */
+    void setResultCacheEnabled(bool enabled);
+
+    /**
+     * @brief setResultCacheDirectory changes the folder of the result cache,
+     *  "results" in the cache folder of the user by default.
+     * @param directory the folder, created when the first result is stored.
+     */
+    void setResultCacheDirectory(QString directory);
+
+    /**
+     * @brief setResultCacheMaxSize sets the bytes the files of the result
+     *  cache can take before the least recently used ones are removed.
+     * @param maxSize the size, RESULT_CACHE_DEFAULT_MAX_SIZE by default.
+     */
+    void setResultCacheMaxSize(qint64 maxSize);
+
     /**
      * @brief convertIntPoints retrieves the vertexes corresponding to every
      *  index.
      * @param indexes The indexes of the vertexes to retrieve.
      * @return a vector with the vertexes.
      */
-    vector<Vertex *> * convertIntPoints(vector<int>* indexes);
+    vector<Vertex> * convertIntPoints(vector<int>* indexes);
 
 };
 
@@ -12,7 +12,8 @@ enum ExceptionType {
     ERROR_WHILE_BINDING,
     MESH_ENGINE_NOT_BINDED,
     UNKNOWN_SEL_METHOD,
-    VALIDATION_ERROR};
+    VALIDATION_ERROR,
+    JOB_CANCELLED};
 
 /**
  * @brief The Exception class manages the known exceptions within the project.
@@ -0,0 +1,43 @@
+#include "Communicator/interestpointsjob.h"
+
+/**
+ * @brief InterestPointsJob::InterestPointsJob starts a job on a new thread.
+ * @param run the calculation, which receives the control of the job and
+ *  returns the interest points.
+ * @param progressCallback function called from the worker threads when the
+ *  progress grows by at least 1%, it may be empty.
+ */
+InterestPointsJob::InterestPointsJob(
+    const std::function<vector<Vertex> * (JobControl *)> & run,
+    const std::function<void(double)> & progressCallback)
+    : BackgroundJob(progressCallback), result(NULL)
+{
+    start([this, run](JobControl * control)
+    {
+        result = run(control);
+    });
+}
+
+/**
+ * @brief InterestPointsJob::~InterestPointsJob cancels the job if it is still
+ *  running, waits for its thread and deletes the result if it was not taken.
+ */
+InterestPointsJob::~InterestPointsJob()
+{
+    stop();
+    delete result;
+}
+
+/**
+ * @brief InterestPointsJob::takeResult waits until the calculation ends and
+ *  returns its result, which can only be taken once.
+ * @return the interest points, owned by the caller.
+ * @throw the exception thrown by the calculation, if any.
+ */
+vector<Vertex> * InterestPointsJob::takeResult()
+{
+    wait();
+    vector<Vertex> * interestPoints = result;
+    result = NULL;
+    return interestPoints;
+}
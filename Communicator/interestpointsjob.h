@@ -0,0 +1,49 @@
+#ifndef INTERESTPOINTSJOB_H
+#define INTERESTPOINTSJOB_H
+
+#include <functional>
+#include <vector>
+#include "BasicStructures/vertex.h"
+#include "Communicator/backgroundjob.h"
+
+using std::vector;
+
+/**
+ * @brief The InterestPointsJob class is the handle of a calculation of
+ *  interest points running on its own thread, as started by
+ *  Communicator::startInterestPoints. The owner takes its result once
+ *  finished.
+ */
+class InterestPointsJob : public BackgroundJob
+{
+private:
+    vector<Vertex> * result;
+
+public:
+    /**
+     * @brief InterestPointsJob starts a job on a new thread.
+     * @param run the calculation, which receives the control of the job and
+     *  returns the interest points.
+     * @param progressCallback function called from the worker threads when
+     *  the progress grows by at least 1%, it may be empty.
+     */
+    InterestPointsJob(
+        const std::function<vector<Vertex> * (JobControl *)> & run,
+        const std::function<void(double)> & progressCallback);
+
+    /**
+     * @brief ~InterestPointsJob cancels the job if it is still running,
+     *  waits for its thread and deletes the result if it was not taken.
+     */
+    ~InterestPointsJob();
+
+    /**
+     * @brief takeResult waits until the calculation ends and returns its
+     *  result, which can only be taken once.
+     * @return the interest points, owned by the caller.
+     * @throw the exception thrown by the calculation, if any.
+     */
+    vector<Vertex> * takeResult();
+};
+
+#endif // INTERESTPOINTSJOB_H
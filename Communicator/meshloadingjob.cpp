@@ -0,0 +1,45 @@
+#include "Communicator/meshloadingjob.h"
+
+/**
+ * @brief MeshLoadingJob::MeshLoadingJob starts a job on a new thread.
+ * @param read the first stage, which receives the control of the job and
+ *  returns true if the mesh must still be completed.
+ * @param complete the second stage, which receives the control of the job.
+ * @param progressCallback function called from the worker threads when the
+ *  progress grows by at least 1%, it may be empty.
+ */
+MeshLoadingJob::MeshLoadingJob(
+    const std::function<bool(JobControl *)> & read,
+    const std::function<void(JobControl *)> & complete,
+    const std::function<void(double)> & progressCallback)
+    : BackgroundJob(progressCallback), meshRead(false)
+{
+    start([this, read, complete](JobControl * control)
+    {
+        bool mustComplete = read(control);
+        meshRead = true;
+        if (mustComplete)
+        {
+            complete(control);
+        }
+    });
+}
+
+/**
+ * @brief MeshLoadingJob::~MeshLoadingJob cancels the job if it is still
+ *  running and waits for its thread.
+ */
+MeshLoadingJob::~MeshLoadingJob()
+{
+    stop();
+}
+
+/**
+ * @brief MeshLoadingJob::isMeshRead
+ * @return true once the files have been read successfully, even if the mesh
+ *  is still being completed.
+ */
+bool MeshLoadingJob::isMeshRead()
+{
+    return meshRead;
+}
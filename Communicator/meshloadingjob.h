@@ -0,0 +1,50 @@
+#ifndef MESHLOADINGJOB_H
+#define MESHLOADINGJOB_H
+
+#include <atomic>
+#include <functional>
+#include "Communicator/backgroundjob.h"
+
+/**
+ * @brief The MeshLoadingJob class is the handle of the loading of a mesh
+ *  running on its own thread, as started by Communicator::startLoadMesh.
+ *  The loading has two stages: the files are read first, and then the mesh
+ *  is completed (its adjacency and its cache). The owner can use the mesh
+ *  for rendering once the first stage is over, but must wait for the job to
+ *  finish before running any calculation on it.
+ */
+class MeshLoadingJob : public BackgroundJob
+{
+private:
+    std::atomic<bool> meshRead;
+
+public:
+    /**
+     * @brief MeshLoadingJob starts a job on a new thread.
+     * @param read the first stage, which receives the control of the job
+     *  and returns true if the mesh must still be completed.
+     * @param complete the second stage, which receives the control of the
+     *  job.
+     * @param progressCallback function called from the worker threads when
+     *  the progress grows by at least 1%, it may be empty.
+     */
+    MeshLoadingJob(
+        const std::function<bool(JobControl *)> & read,
+        const std::function<void(JobControl *)> & complete,
+        const std::function<void(double)> & progressCallback);
+
+    /**
+     * @brief ~MeshLoadingJob cancels the job if it is still running and waits
+     *  for its thread.
+     */
+    ~MeshLoadingJob();
+
+    /**
+     * @brief isMeshRead
+     * @return true once the files have been read successfully, even if the
+     *  mesh is still being completed.
+     */
+    bool isMeshRead();
+};
+
+#endif // MESHLOADINGJOB_H
@@ -0,0 +1,269 @@
+#include "Communicator/resultcache.h"
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <cstring>
+
+/**
+ * @brief ResultCache::ResultCache creates a cache in the cache folder of the user
+ */
+ResultCache::ResultCache()
+{
+    directory = QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/results";
+    maxSize = RESULT_CACHE_DEFAULT_MAX_SIZE;
+}
+
+/**
+ * @brief ResultCache::ResultCache creates a cache in a folder
+ * @param directory the folder, created when the first result is written
+ */
+ResultCache::ResultCache(const QString & directory)
+{
+    this->directory = directory;
+    maxSize = RESULT_CACHE_DEFAULT_MAX_SIZE;
+}
+
+/**
+ * @brief ResultCache::getDirectory
+ * @return the folder of the cache
+ */
+QString ResultCache::getDirectory()
+{
+    return directory;
+}
+
+/**
+ * @brief ResultCache::getMaxSize
+ * @return the bytes the result files can take before the least recently used are removed
+ */
+qint64 ResultCache::getMaxSize()
+{
+    return maxSize;
+}
+
+/**
+ * @brief ResultCache::setMaxSize sets the bytes the result files can take,
+ *  applied on the next write
+ * @param maxSize the size, RESULT_CACHE_DEFAULT_MAX_SIZE by default
+ */
+void ResultCache::setMaxSize(qint64 maxSize)
+{
+    this->maxSize = maxSize;
+}
+
+/**
+ * @brief ResultCache::hashBytes continues a FNV-1a hash with a block of
+ *  memory, taking 8 bytes on every step and folding the high bits of the hash
+ *  back into the low ones, which a multiplication alone does not reach
+ * @param data the block of memory
+ * @param size the number of bytes of the block
+ * @param hash the hash of the previous blocks
+ * @return the hash including the block
+ */
+quint64 ResultCache::hashBytes(const void * data, size_t size, quint64 hash)
+{
+    const quint64 prime = 1099511628211ULL;
+    const char * bytes = static_cast<const char *>(data);
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8)
+    {
+        quint64 word;
+        memcpy(&word, bytes + i, 8);
+        hash = (hash ^ word) * prime;
+        hash ^= hash >> 32;
+    }
+    for (; i < size; i++)
+    {
+        hash = (hash ^ quint8(bytes[i])) * prime;
+    }
+    return hash;
+}
+
+/**
+ * @brief ResultCache::hashMesh computes a hash of the coordinates and faces of a mesh
+ * @param mesh the mesh
+ * @return the hash
+ */
+quint64 ResultCache::hashMesh(Mesh * mesh)
+{
+    qint64 sizes[2] = {mesh->getNumVertexes(), mesh->getNumFaces()};
+    quint64 hash = hashBytes(sizes, sizeof(sizes), 14695981039346656037ULL);
+    hash = hashBytes(mesh->getCoordinates(), 3 * sizeof(double) * (size_t)sizes[0], hash);
+    return hashBytes(mesh->getTriangles(), 3 * sizeof(int) * (size_t)sizes[1], hash);
+}
+
+/**
+ * @brief ResultCache::makeKey builds the key of a query
+ * @param meshHash the hash of the mesh, as returned by hashMesh
+ * @param mesh the mesh
+ * @param numRings the number of rings of the query
+ * @param k the harris param of the query
+ * @param percentageOfPoints the percentage of interest points of the query
+ * @param selectionMode the selection mode of the query
+ * @return the key, as stored in the header of the result file
+ */
+ResultCacheHeader ResultCache::makeKey(quint64 meshHash, Mesh * mesh, int numRings, double k,
+                                       double percentageOfPoints, SelectionMode selectionMode)
+{
+    ResultCacheHeader key;
+    memset(&key, 0, sizeof(key));
+    memcpy(key.magic, RESULT_CACHE_MAGIC, sizeof(key.magic));
+    key.version = RESULT_CACHE_VERSION;
+    key.byteOrder = RESULT_CACHE_BYTE_ORDER;
+    key.meshHash = meshHash;
+    key.numVertexes = mesh->getNumVertexes();
+    key.numFaces = mesh->getNumFaces();
+    key.numRings = numRings;
+    key.selectionMode = selectionMode;
+    key.k = k;
+    key.percentageOfPoints = percentageOfPoints;
+    return key;
+}
+
+/**
+ * @brief ResultCache::getFileName gets the path of the file of a query
+ * @param key the key of the query
+ * @return the path of the file, inside the folder of the cache
+ */
+QString ResultCache::getFileName(const ResultCacheHeader & key)
+{
+    ResultCacheHeader keyOnly = key;
+    keyOnly.numInterestPoints = 0;
+    quint64 hash = hashBytes(&keyOnly, sizeof(keyOnly), 14695981039346656037ULL);
+    return directory + QString("/%1.hipr").arg(hash, 16, 16, QChar('0'));
+}
+
+/**
+ * @brief ResultCache::read reads the result of a query, and marks its file
+ *  as recently used
+ * @param key the key of the query, as returned by makeKey
+ * @param harrisValues receives the Harris response of every vertex
+ * @param interestPoints receives the indexes of the interest points
+ * @return false if the result is not in the cache or its file is not valid
+ */
+bool ResultCache::read(const ResultCacheHeader & key, VectorXd & harrisValues, vector<int> & interestPoints)
+{
+    QFile myFile(getFileName(key));
+    if (!myFile.exists() || !myFile.open(QIODevice::ReadOnly))
+    {
+        return false;
+    }
+
+    // Every field of the key must match, a file with the same name could
+    // come from another query if their hashes collide
+    ResultCacheHeader header;
+    if (myFile.read(reinterpret_cast<char *>(&header), sizeof(header)) != sizeof(header))
+    {
+        return false;
+    }
+    qint64 numInterestPoints = header.numInterestPoints;
+    header.numInterestPoints = 0;
+    if (memcmp(&header, &key, sizeof(header)) != 0
+        || numInterestPoints < 0 || numInterestPoints > key.numVertexes)
+    {
+        return false;
+    }
+    qint64 numValues = key.numVertexes;
+    qint64 expectedSize = sizeof(header) + numValues * sizeof(double) + numInterestPoints * sizeof(int);
+    if (myFile.size() != expectedSize)
+    {
+        return false;
+    }
+
+    harrisValues.resize(numValues);
+    interestPoints.resize(numInterestPoints);
+    qint64 valuesSize = numValues * sizeof(double);
+    qint64 pointsSize = numInterestPoints * sizeof(int);
+    if (myFile.read(reinterpret_cast<char *>(harrisValues.data()), valuesSize) != valuesSize
+        || myFile.read(reinterpret_cast<char *>(interestPoints.data()), pointsSize) != pointsSize)
+    {
+        return false;
+    }
+    for (unsigned int i = 0; i < interestPoints.size(); i++)
+    {
+        if (interestPoints[i] < 0 || interestPoints[i] >= key.numVertexes)
+        {
+            return false;
+        }
+    }
+
+    // The modification time orders the files for the eviction. Rewriting
+    // the first byte updates it on every Qt version, failing to do it only
+    // makes this file older than it should be
+    myFile.close();
+    QFile touchedFile(myFile.fileName());
+    if (touchedFile.open(QIODevice::ReadWrite))
+    {
+        touchedFile.write(RESULT_CACHE_MAGIC, 1);
+    }
+    return true;
+}
+
+/**
+ * @brief ResultCache::write stores the result of a query, replacing the
+ *  previous one, and removes the least recently used files if the folder is
+ *  over its maximum size
+ * @param key the key of the query, as returned by makeKey
+ * @param harrisValues the Harris response of every vertex
+ * @param interestPoints the indexes of the interest points
+ * @return false if the file could not be written
+ */
+bool ResultCache::write(const ResultCacheHeader & key, const VectorXd & harrisValues,
+                        const vector<int> & interestPoints)
+{
+    if (harrisValues.size() != key.numVertexes || !QDir().mkpath(directory))
+    {
+        return false;
+    }
+
+    ResultCacheHeader header = key;
+    header.numInterestPoints = interestPoints.size();
+    QSaveFile myFile(getFileName(key));
+    if (!myFile.open(QIODevice::WriteOnly))
+    {
+        return false;
+    }
+    qint64 valuesSize = harrisValues.size() * sizeof(double);
+    qint64 pointsSize = interestPoints.size() * sizeof(int);
+    qint64 written = myFile.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    written += myFile.write(reinterpret_cast<const char *>(harrisValues.data()), valuesSize);
+    written += myFile.write(reinterpret_cast<const char *>(interestPoints.data()), pointsSize);
+    if (written != qint64(sizeof(header)) + valuesSize + pointsSize)
+    {
+        myFile.cancelWriting();
+    }
+    if (!myFile.commit())
+    {
+        return false;
+    }
+    evict(myFile.fileName());
+    return true;
+}
+
+/**
+ * @brief ResultCache::evict removes the least recently used result files
+ *  until the ones left take at most maxSize bytes
+ * @param keep the path of a file that is never removed, the one just written
+ */
+void ResultCache::evict(const QString & keep)
+{
+    // Sorted from the newest to the oldest, so once the files seen do not
+    // fit in maxSize, the rest are removed
+    QFileInfoList files = QDir(directory).entryInfoList(QStringList() << "*.hipr", QDir::Files, QDir::Time);
+    QString keepPath = QFileInfo(keep).absoluteFilePath();
+    qint64 totalSize = QFileInfo(keep).size();
+    for (int i = 0; i < files.size(); i++)
+    {
+        if (files[i].absoluteFilePath() == keepPath)
+        {
+            continue;
+        }
+        totalSize += files[i].size();
+        if (totalSize > maxSize)
+        {
+            QFile::remove(files[i].absoluteFilePath());
+        }
+    }
+}
@@ -0,0 +1,177 @@
+#ifndef RESULTCACHE_H
+#define RESULTCACHE_H
+
+#include <QString>
+#include <QtGlobal>
+#include "BasicStructures/mesh.h"
+#include "Engine/engine.h"
+
+/**
+ * Result cache file (.hipr) written by the Communicator after computing the
+ * interest points of a mesh, so that the same query on the same mesh does
+ * not run the Engine again.
+ *
+ * The file starts with a ResultCacheHeader, which holds the whole key of the
+ * query, followed by the Harris response of every vertex (numVertexes
+ * double) and the indexes of the interest points (numInterestPoints
+ * qint32, the ints of the Engine, rejected on read when they are negative
+ * or not lower than numVertexes). Values are stored in the byte order of the machine that wrote
+ * the file, as in the mesh cache.
+ */
+
+/**
+ * @brief RESULT_CACHE_MAGIC first 8 bytes of every result file
+ */
+static const char RESULT_CACHE_MAGIC[8] = {'H', 'I', 'P', 'R', 'S', 'L', 'T', '\0'};
+
+/**
+ * @brief RESULT_CACHE_VERSION version of the layout, files with another one are ignored
+ */
+static const quint32 RESULT_CACHE_VERSION = 1;
+
+/**
+ * @brief RESULT_CACHE_BYTE_ORDER written as a quint32 to detect the byte order of the file
+ */
+static const quint32 RESULT_CACHE_BYTE_ORDER = 0x01020304;
+
+/**
+ * @brief RESULT_CACHE_DEFAULT_MAX_SIZE bytes the result files of a folder can
+ *  take before the least recently used ones are removed
+ */
+static const qint64 RESULT_CACHE_DEFAULT_MAX_SIZE = 512LL * 1024 * 1024;
+
+/**
+ * @brief The ResultCacheHeader struct is the first block of a result file.
+ *  Every field but numInterestPoints is part of the key of the query.
+ */
+struct ResultCacheHeader
+{
+    char magic[8];
+    quint32 version;
+    quint32 byteOrder;
+    quint64 meshHash;
+    qint32 numVertexes;
+    qint32 numFaces;
+    qint32 numRings;
+    qint32 selectionMode;
+    double k;
+    double percentageOfPoints;
+    qint64 numInterestPoints;
+};
+
+static_assert(sizeof(ResultCacheHeader) == 64, "The result header must not depend on the compiler");
+static_assert(sizeof(int) == sizeof(qint32), "The indexes are stored as the ints of the Engine");
+
+/**
+ * @brief The ResultCache class stores the Harris response and the interest
+ *  points of a query in a folder, one file per query, named after a hash of
+ *  its key. The mesh is identified by a hash of its coordinates and faces,
+ *  so the same mesh read from different files shares its results.
+ *  By default the folder is "results" inside the cache folder of the user
+ *  (QStandardPaths::CacheLocation). A file takes about 8 bytes per vertex,
+ *  so after every write the least recently used files, by modification
+ *  time, are removed until the folder is under a maximum size. Reading a
+ *  result updates the modification time of its file.
+ */
+class ResultCache
+{
+private:
+    QString directory;
+    qint64 maxSize;
+
+    /**
+     * @brief getFileName gets the path of the file of a query
+     * @param key the key of the query
+     * @return the path of the file, inside the folder of the cache
+     */
+    QString getFileName(const ResultCacheHeader & key);
+
+    /**
+     * @brief hashBytes continues a FNV-1a hash with a block of memory, taking
+     *  8 bytes on every step and folding the high bits of the hash back into
+     *  the low ones, which a multiplication alone does not reach
+     * @param data the block of memory
+     * @param size the number of bytes of the block
+     * @param hash the hash of the previous blocks
+     * @return the hash including the block
+     */
+    static quint64 hashBytes(const void * data, size_t size, quint64 hash);
+
+    /**
+     * @brief evict removes the least recently used result files until the
+     *  ones left take at most maxSize bytes
+     * @param keep the path of a file that is never removed, the one just written
+     */
+    void evict(const QString & keep);
+
+public:
+    /**
+     * @brief ResultCache creates a cache in the cache folder of the user
+     */
+    ResultCache();
+
+    /**
+     * @brief ResultCache creates a cache in a folder
+     * @param directory the folder, created when the first result is written
+     */
+    ResultCache(const QString & directory);
+
+    /**
+     * @brief getDirectory
+     * @return the folder of the cache
+     */
+    QString getDirectory();
+
+    /**
+     * @brief getMaxSize
+     * @return the bytes the result files can take before the least recently used are removed
+     */
+    qint64 getMaxSize();
+
+    /**
+     * @brief setMaxSize sets the bytes the result files can take, applied on the next write
+     * @param maxSize the size, RESULT_CACHE_DEFAULT_MAX_SIZE by default
+     */
+    void setMaxSize(qint64 maxSize);
+
+    /**
+     * @brief hashMesh computes a hash of the coordinates and faces of a mesh
+     * @param mesh the mesh
+     * @return the hash
+     */
+    static quint64 hashMesh(Mesh * mesh);
+
+    /**
+     * @brief makeKey builds the key of a query
+     * @param meshHash the hash of the mesh, as returned by hashMesh
+     * @param mesh the mesh
+     * @param numRings the number of rings of the query
+     * @param k the harris param of the query
+     * @param percentageOfPoints the percentage of interest points of the query
+     * @param selectionMode the selection mode of the query
+     * @return the key, as stored in the header of the result file
+     */
+    static ResultCacheHeader makeKey(quint64 meshHash, Mesh * mesh, int numRings, double k,
+                                     double percentageOfPoints, SelectionMode selectionMode);
+
+    /**
+     * @brief read reads the result of a query, and marks its file as recently used
+     * @param key the key of the query, as returned by makeKey
+     * @param harrisValues receives the Harris response of every vertex
+     * @param interestPoints receives the indexes of the interest points
+     * @return false if the result is not in the cache or its file is not valid
+     */
+    bool read(const ResultCacheHeader & key, VectorXd & harrisValues, vector<int> & interestPoints);
+
+    /**
+     * @brief write stores the result of a query, replacing the previous one,
+     *  and removes the least recently used files if the folder is over its maximum size
+     * @param key the key of the query, as returned by makeKey
+     * @param harrisValues the Harris response of every vertex
+     * @param interestPoints the indexes of the interest points
+     * @return false if the file could not be written
+     */
+    bool write(const ResultCacheHeader & key, const VectorXd & harrisValues, const vector<int> & interestPoints);
+};
+
+#endif // RESULTCACHE_H
@@ -10,7 +10,71 @@ using std::sort;
  */
 Engine::Engine()
 {
+    numThreads = defaultThreadCount();
+    coefficientsRevision = 0;
+    coefficientsRings = 0;
+    control = NULL;
+    profile = NULL;
+}
+
+/**
+ * @brief setNumThreads defines the number of threads used to compute the
+ *  Harris response of the vertexes. The result does not depend on it.
+ * @param numThreads number of threads, 0 or less uses all the hardware threads
+ */
+void Engine::setNumThreads(int numThreads)
+{
+    this->numThreads = (numThreads > 0)? numThreads : defaultThreadCount();
+}
+
+/**
+ * @brief getNumThreads
+ * @return the number of threads used to compute the Harris response
+ */
+int Engine::getNumThreads()
+{
+    return numThreads;
+}
+
+/**
+ * @brief setJobControl defines the control of the next computations. The
+ *  computation of the coefficients reports its progress to it and stops
+ *  early if it is cancelled, leaving no coefficients kept.
+ * @param control the control, or NULL to run without one
+ */
+void Engine::setJobControl(JobControl * control)
+{
+    this->control = control;
+}
+
+/**
+ * @brief isCancelled
+ * @return true if the control of the computations has been cancelled, in
+ *  which case their results must be discarded
+ */
+bool Engine::isCancelled()
+{
+    return control != NULL && control->isCancelled();
+}
+
+/**
+ * @brief setProfile defines the profile that accumulates the wall time and the
+ *  number of calls of every stage of the next computations, per thread. It is
+ *  not reset, so several queries can be added up.
+ * @param profile the profile, or NULL to run without timing the stages
+ */
+void Engine::setProfile(StageProfile * profile)
+{
+    this->profile = profile;
+}
 
+/**
+ * @brief getProfile
+ * @return the profile of the computations, NULL if they are not timed
+ */
+StageProfile * Engine::getProfile()
+{
+    return profile;
 }
 
 /**
@@ -21,155 +85,432 @@ Engine::Engine()
  * @param percentageOfPoints is a double indicating how many points should be considered as interest points
  * @param selectionMode is a string defining the type of selection for the interest points
  * @return vector of integers with indixes of vertexes that are of interest
+ *  (NULL if the job control is cancelled)
  */
 vector<int> * Engine::findInterestPoints(
     Mesh * theMesh, int numRings, double k, double percentageOfPoints, SelectionMode selectionMode)
 {
-    Engine computations = Engine();
-    MatrixXd vertexes = computations.getVertexesFromMesh(theMesh);
-    MatrixXi faces = computations.getFacesFromMesh(theMesh);
-    int numVertexes = vertexes.rows();
+    VectorXd harrisValues = this->computeHarrisResponses(theMesh, numRings, k);
+    if(this->isCancelled())
+    {
+        return NULL;
+    }
+    return this->selectInterestPoints(theMesh, harrisValues, percentageOfPoints, selectionMode);
+}
+
+/**
+ * @brief computeHarrisResponses computes the Harris operator of every vertex of a mesh
+ * @param theMesh Mesh sent by communicator for computing interest points
+ * @param numRings Number of rings to be considered for the computation of neighbourhood
+ * @param k Constant for Harris operator computation (Equation 3 in paper)
+ * @return vector with the value of the Harris operator of every vertex
+ */
+VectorXd Engine::computeHarrisResponses(Mesh * theMesh, int numRings, double k)
+{
+    const HarrisCoefficients & coefficients = this->computeCoefficients(theMesh, numRings);
+    int numVertexes = coefficients.rows();
     VectorXd harrisValues(numVertexes); //Vector for storing values of harris operator for each vertex
+    if(this->isCancelled())
+    {
+        //The coefficients are incomplete
+        harrisValues.setZero();
+        return harrisValues;
+    }
 
-    //For each vertex, compute harris operator
-    for(int iVertex=0; iVertex< vertexes.rows(); iVertex++)
+    //Only the Harris operator depends on k, from the coefficients of every vertex
+    ProfileTimer timer(profile, STAGE_RESPONSE);
+    parallelFor(0, numVertexes, numThreads, 4096, [&](int iVertex, int)
     {
-        //Get indexes of faces that contain current vertex
-        VectorXi facesForThisVertex = computations.getFacesForVertex(theMesh, iVertex);
-        //Get indexes of direct neighbours:
-        VectorXi neighbours = computations.getDirectNeighbours(iVertex, faces, facesForThisVertex);
-        //Get indexes of vertexes in neighbourhood k
-        VectorXi kRings = computations.getRings(iVertex, numRings, faces, neighbours, theMesh);
-        //Get matrix with points in neighbourhood k (convert indexes to points)
-        MatrixXd pointskRings = computations.getVertexesFromIndexes(kRings, theMesh);
-        //Find location of current point in vector of indexes of neighbourhood k
-        int currentVertexIndexInkRings = computations.getVertexIndexInNeighbourhood(iVertex, kRings);
-		MatrixXd Centroid;
-        //Center points
-		MatrixXd centeredPoints = computations.centerNeighbourhood(pointskRings, Centroid);
-        //Rotate
-		MatrixXd rotatedPoints  = computations.rotateToFitPlane(centeredPoints,currentVertexIndexInkRings);
-        //Fit surface to points
-        MatrixXd fittedSurface = computations.fitQuadraticSurface(rotatedPoints,currentVertexIndexInkRings);
-        //Find derivative of surface
-        MatrixXd matrixE = computations.findderivativeEmatrix(fittedSurface);
-        //Compute Harris operator
-        double harrisOperator = computations.computeHarris(matrixE, k);
-        //Store value of Harris operator for current point
-        harrisValues(iVertex) = harrisOperator;
+        harrisValues(iVertex) = this->computeHarris(
+            coefficients(iVertex, 0), coefficients(iVertex, 1), coefficients(iVertex, 2), k);
+    });
+
+    return harrisValues;
+}
+
+/**
+ * @brief computeCoefficients computes the coefficients A, B, C of the matrix E
+ *  of every vertex of a mesh, which are all the Harris operator needs. They are
+ *  kept until the mesh changes or another mesh or number of rings is used, so
+ *  that queries that only change k or the selection do not compute them again.
+ * @param theMesh Mesh sent by communicator for computing interest points
+ * @param numRings Number of rings to be considered for the computation of neighbourhood
+ * @return matrix with the coefficients A, B, C of every vertex in its rows
+ */
+const HarrisCoefficients & Engine::computeCoefficients(Mesh * theMesh, int numRings)
+{
+    if(hasCoefficients(theMesh, numRings))
+    {
+        return coefficients;
     }
 
-    //Make pre - selection of interest pointsd
-    set <int> preSelected;
-    bool discard(false);
-    //Pre-selection of points
-    for(int iVertex=0; iVertex< numVertexes; iVertex++)
+    MatrixXd vertexes = this->getVertexesFromMesh(theMesh);
+    Adjacency * adjacency = NULL;
     {
-        discard = false;
-        //Get indexes of faces that contain current vertex
-        VectorXi facesForThisVertex = this->getFacesForVertex(theMesh, iVertex);
-        //Get indexes of direct neighbours:
-        VectorXi neighbours = this->getDirectNeighbours(iVertex, faces, facesForThisVertex);
-        //For each point, evaluate if its Harris response is greater than the one of its direct neighbours
-        for(int iNeighbour=0; iNeighbour < neighbours.size(); iNeighbour++)
+        ProfileTimer timer(profile, STAGE_ADJACENCY);
+        adjacency = theMesh->getAdjacency();
+    }
+    int numVertexes = vertexes.rows();
+    int ringDepth = this->getRingDepth(numRings);
+    coefficients.resize(numVertexes, 3);
+    coefficientsRevision = 0;
+    //Each thread gathers neighbourhoods with its own buffers
+    vector<RingGatherer> gatherers(numThreads);
+    if(control != NULL)
+    {
+        control->startStage(numVertexes);
+    }
+    //When profiling, the first and last time every thread works on a vertex,
+    //padded so that two threads do not write to the same cache line
+    typedef StageProfile::Clock Clock;
+    struct ThreadSpan
+    {
+        Clock::time_point first;
+        Clock::time_point last;
+        char padding[48];
+    };
+    vector<ThreadSpan> spans;
+    if(profile != NULL)
+    {
+        profile->prepare(numThreads);
+        spans.resize(numThreads);
+    }
+
+    //For each vertex, compute its coefficients. Every vertex is independent from
+    //the others, so they are distributed among the threads in chunks and each
+    //thread writes only the rows of coefficients of its own vertexes. The job
+    //control is checked and updated once per chunk, not once per vertex, so
+    //that the threads do not share a counter in the per-vertex loop.
+    const int vertexesPerChunk = 64;
+    int numChunks = (numVertexes + vertexesPerChunk - 1) / vertexesPerChunk;
+    parallelFor(0, numChunks, numThreads, 1, [&](int iChunk, int threadId)
+    {
+        //Once cancelled, the remaining vertexes are skipped
+        if(control != NULL && control->isCancelled())
         {
-            if(harrisValues(iVertex) < harrisValues(neighbours(iNeighbour)))
+            return;
+        }
+        int chunkBegin = iChunk * vertexesPerChunk;
+        int chunkEnd = std::min(numVertexes, chunkBegin + vertexesPerChunk);
+        for(int iVertex = chunkBegin; iVertex < chunkEnd; iVertex++)
+        {
+            //Each stage ends by adding the time since the end of the previous one
+            Clock::time_point time;
+            if(profile != NULL)
             {
-                discard = true;
-                break;
+                time = Clock::now();
+                if(spans[threadId].first == Clock::time_point())
+                {
+                    spans[threadId].first = time;
+                }
+            }
+            auto endStage = [&](ProfileStage stage)
+            {
+                if(profile != NULL)
+                {
+                    Clock::time_point now = Clock::now();
+                    profile->add(stage, threadId, time, now);
+                    time = now;
+                }
+            };
+
+            //Get indexes of vertexes in neighbourhood k
+            Map<const VectorXi> kRings = gatherers[threadId].gather(iVertex, ringDepth, adjacency);
+            endStage(STAGE_RINGS);
+            //Get matrix with points in neighbourhood k (convert indexes to points)
+            MatrixXd pointskRings = this->getVertexesFromIndexes(kRings, vertexes);
+            endStage(STAGE_GATHER);
+            //Find location of current point in vector of indexes of neighbourhood k
+            int currentVertexIndexInkRings = this->getVertexIndexInNeighbourhood(iVertex, kRings);
+            MatrixXd Centroid;
+            //Center points
+            MatrixXd centeredPoints = this->centerNeighbourhood(pointskRings, Centroid);
+            endStage(STAGE_CENTERING);
+            //Find rotation to the fitting plane
+            Matrix3d rotation = this->computeRotationToFitPlane(centeredPoints,currentVertexIndexInkRings);
+            endStage(STAGE_PCA);
+            //Fit surface to the rotated points
+            Matrix<double, 6, 1> fittedSurface = this->fitQuadraticSurfaceNormalEquations(centeredPoints, rotation);
+            endStage(STAGE_FIT);
+            //Find derivative of surface
+            MatrixXd matrixE = this->findderivativeEmatrix(fittedSurface);
+            //Store A, B, C for current point
+            coefficients(iVertex, 0) = matrixE(0,0);
+            coefficients(iVertex, 1) = matrixE(1,1);
+            coefficients(iVertex, 2) = matrixE(0,1);
+            endStage(STAGE_EMATRIX);
+            if(profile != NULL)
+            {
+                spans[threadId].last = time;
             }
         }
-        if(!discard)
+        if(control != NULL)
         {
-            preSelected.insert(iVertex);
+            control->addDone(chunkEnd - chunkBegin);
         }
-    }
+    });
 
-    //Convert set to VectorXi
-    int numPreselected = preSelected.size();
-    VectorXi preSelectedVertexes(numPreselected);
-    int ctrlVar1(0);
-    for (set<int>::iterator it=preSelected.begin(); it!=preSelected.end(); ++it)
+    //The per-vertex loop of every thread is a span of the timeline
+    for(unsigned int iThread = 0; iThread < spans.size(); iThread++)
     {
-        preSelectedVertexes(ctrlVar1) = *it;
-        ctrlVar1++;
+        if(spans[iThread].first != Clock::time_point())
+        {
+            profile->addSpan(STAGE_COEFFICIENTS, iThread, spans[iThread].first, spans[iThread].last);
+        }
     }
 
-    //Get vector with harris values
-    VectorXd preSelectedHarrisValues(numPreselected);
-    for(int iPre = 0; iPre < numPreselected; iPre++ )
+    if(this->isCancelled())
     {
-        preSelectedHarrisValues(iPre) = harrisValues(preSelectedVertexes(iPre));
+        return coefficients;
     }
+    coefficientsRevision = theMesh->getRevision();
+    coefficientsRings = numRings;
+    return coefficients;
+}
 
-    vector <int> preSelectedSorted;
+/**
+ * @brief hasCoefficients checks if the coefficients of a mesh are already computed
+ * @param theMesh Mesh sent by communicator for computing interest points
+ * @param numRings Number of rings to be considered for the computation of neighbourhood
+ * @return true if computeCoefficients would return them without computing them
+ */
+bool Engine::hasCoefficients(Mesh * theMesh, int numRings)
+{
+    return coefficientsRevision != 0 && coefficientsRevision == theMesh->getRevision()
+            && coefficientsRings == numRings;
+}
 
-    double maxi(0);
-    for(int iIP = 0; iIP < preSelectedVertexes.size(); iIP++)
-    {
-        maxi = preSelectedHarrisValues.maxCoeff();
-        for(int i=0; i<preSelectedVertexes.size(); i++)
-        {
-            if(abs(maxi-preSelectedHarrisValues(i))<0.00001)
-            {
-                preSelectedSorted.push_back(preSelectedVertexes(i));
-                preSelectedHarrisValues(i) = 0;
-                break;
-            }
-        }
+/**
+ * @brief clearCoefficients releases the coefficients kept by computeCoefficients
+ */
+void Engine::clearCoefficients()
+{
+    coefficients.resize(0, 3);
+    coefficientsRevision = 0;
+}
 
-    }
+/**
+ * @brief selectInterestPoints selects the interest points of a mesh from the
+ *  Harris operator of its vertexes
+ * @param theMesh Mesh sent by communicator for computing interest points
+ * @param harrisValues Harris operator of every vertex, as returned by computeHarrisResponses
+ * @param percentageOfPoints is a double indicating how many points should be considered as interest points
+ * @param selectionMode is an enumeration item defining the type of selection for the interest points
+ * @return vector of integers with indixes of vertexes that are of interest
+ */
+vector<int> * Engine::selectInterestPoints(
+    Mesh * theMesh, const Ref<const VectorXd> & harrisValues, double percentageOfPoints, SelectionMode selectionMode)
+{
+    int numVertexes = harrisValues.size();
+    vector<int> preSelected = this->preselectInterestPoints(theMesh, harrisValues);
+    int numPreselected = preSelected.size();
 
     if(selectionMode == SelectionMode::FRACTION)
     {
         //Selection according to points with highest Harris response
-        int numPointsToChoose = int(percentageOfPoints*numVertexes);
-        if(numPointsToChoose>preSelectedVertexes.size() || numPointsToChoose == 0)
-        {
-            numPointsToChoose = preSelectedVertexes.size();
-        }
+        int numPointsToChoose = this->getNumPointsToChoose(percentageOfPoints, numVertexes, numPreselected);
 
-        vector<int> * interestPoints = new vector<int>;
-        for(int i=0; i<numPointsToChoose; i++)
-        {
-            interestPoints->push_back(preSelectedSorted.at(i));
-        }
+        //Only the chosen points have to be sorted
+        this->sortByHarrisResponse(preSelected, harrisValues, numPointsToChoose);
+        ProfileTimer timer(profile, STAGE_SELECTION);
+        vector<int> * interestPoints =
+            new vector<int>(preSelected.begin(), preSelected.begin() + numPointsToChoose);
         return interestPoints;
     }
     else if(selectionMode == SelectionMode::CLUSTERING)
     {
+        //Candidates are visited from the highest to the lowest Harris response
+        vector<int> & preSelectedSorted = preSelected;
+        this->sortByHarrisResponse(preSelectedSorted, harrisValues, numPreselected);
+
+        ProfileTimer timer(profile, STAGE_SELECTION);
+        MatrixXd vertexes = this->getVertexesFromMesh(theMesh);
         double diagonalOftheObject;
-        diagonalOftheObject = computations.getDiagonalOfMesh( vertexes );
+        diagonalOftheObject = this->getDiagonalOfMesh( vertexes );
         double rho = diagonalOftheObject * ( 1 - percentageOfPoints );
 
         vector<int> * interestPoints = new vector<int>;
-        for( unsigned int i = 0 ; i < preSelectedSorted.size() ; i++ )
+        this->clusterInterestPoints(vertexes, preSelectedSorted, rho, *interestPoints);
+        return interestPoints;
+    }
+    else
+    {
+        return NULL;
+    }
+
+
+    return NULL;
+}
+
+/**
+ * @brief sweepParameters finds the interest points of a mesh for every
+ *  combination of the values of a parameter grid. The coefficients of the
+ *  vertexes are computed once per number of rings, and the Harris response,
+ *  the pre-selection and the sorting of the candidates once per value of k;
+ *  every percentage and selection mode only selects from those candidates.
+ * @param theMesh Mesh sent by communicator for computing interest points
+ * @param grid values of every parameter
+ * @return table with the interest points of every combination, in the order
+ *  numRings, k, percentageOfPoints, selectionMode, the last one changing fastest.
+ *  NULL if the job control is cancelled.
+ */
+SweepTable * Engine::sweepParameters(Mesh * theMesh, const ParameterGrid & grid)
+{
+    SweepTable * table = new SweepTable;
+    MatrixXd vertexes = this->getVertexesFromMesh(theMesh);
+    int numVertexes = vertexes.rows();
+    //Only the CLUSTERING selection uses the diagonal, it is computed on its first case
+    double diagonalOftheObject = -1;
+    vector<int> interestPoints;
+
+    for(unsigned int iRings = 0; iRings < grid.numRings.size(); iRings++)
+    {
+        int numRings = grid.numRings[iRings];
+        for(unsigned int iK = 0; iK < grid.k.size(); iK++)
         {
-            bool isInterstpoint = true;
-            MatrixXd candidateVertex = vertexes.row(preSelectedSorted.at(i));
-            for( unsigned int j = 0 ; j < interestPoints->size() ; j++ )
+            double k = grid.k[iK];
+            VectorXd harrisValues = this->computeHarrisResponses(theMesh, numRings, k);
+            if(this->isCancelled())
             {
-                MatrixXd difference = candidateVertex - vertexes.row(interestPoints->at(j));
-                double distance = difference.norm();
-                if( distance < rho)
+                delete table;
+                return NULL;
+            }
+
+            //Candidates sorted from the highest to the lowest Harris response, the
+            //points chosen by a fraction are always the first ones
+            vector<int> preSelectedSorted = this->preselectInterestPoints(theMesh, harrisValues);
+            int numPreselected = preSelectedSorted.size();
+            this->sortByHarrisResponse(preSelectedSorted, harrisValues, numPreselected);
+
+            for(unsigned int iPercentage = 0; iPercentage < grid.percentageOfPoints.size(); iPercentage++)
+            {
+                double percentageOfPoints = grid.percentageOfPoints[iPercentage];
+                for(unsigned int iMode = 0; iMode < grid.selectionModes.size(); iMode++)
                 {
-                   isInterstpoint = false;
+                    ProfileTimer timer(profile, STAGE_SELECTION);
+                    SweepCase sweepCase;
+                    sweepCase.numRings = numRings;
+                    sweepCase.k = k;
+                    sweepCase.percentageOfPoints = percentageOfPoints;
+                    sweepCase.selectionMode = grid.selectionModes[iMode];
+                    sweepCase.firstPoint = table->interestPoints.size();
+
+                    if(sweepCase.selectionMode == SelectionMode::FRACTION)
+                    {
+                        int numPointsToChoose =
+                            this->getNumPointsToChoose(percentageOfPoints, numVertexes, numPreselected);
+                        table->interestPoints.insert(table->interestPoints.end(), preSelectedSorted.begin(),
+                                                     preSelectedSorted.begin() + numPointsToChoose);
+                    }
+                    else
+                    {
+                        if(diagonalOftheObject < 0)
+                        {
+                            diagonalOftheObject = this->getDiagonalOfMesh( vertexes );
+                        }
+                        double rho = diagonalOftheObject * ( 1 - percentageOfPoints );
+                        this->clusterInterestPoints(vertexes, preSelectedSorted, rho, interestPoints);
+                        table->interestPoints.insert(table->interestPoints.end(),
+                                                     interestPoints.begin(), interestPoints.end());
+                    }
+                    sweepCase.numPoints = table->interestPoints.size() - sweepCase.firstPoint;
+                    table->cases.push_back(sweepCase);
                 }
             }
-            if ( isInterstpoint == true)
+        }
+    }
+    return table;
+}
+
+/**
+ * @brief preselectInterestPoints finds the vertexes whose Harris response is
+ *  not lower than the one of any of their direct neighbours
+ * @param theMesh Mesh sent by communicator for computing interest points
+ * @param harrisValues Harris operator of every vertex, as returned by computeHarrisResponses
+ * @return indexes of the candidates, in increasing order
+ */
+vector<int> Engine::preselectInterestPoints(Mesh * theMesh, const Ref<const VectorXd> & harrisValues)
+{
+    ProfileTimer timer(profile, STAGE_NMS);
+    Adjacency * adjacency = theMesh->getAdjacency();
+    int numVertexes = harrisValues.size();
+
+    //Make pre - selection of interest pointsd
+    vector<int> preSelected;
+    bool discard(false);
+    //Pre-selection of points
+    for(int iVertex=0; iVertex< numVertexes; iVertex++)
+    {
+        discard = false;
+        //Get indexes of direct neighbours:
+        const int * neighbours = adjacency->getNeighbours(iVertex);
+        int numNeighbours = adjacency->getNumNeighbours(iVertex);
+        //For each point, evaluate if its Harris response is greater than the one of its direct neighbours
+        for(int iNeighbour=0; iNeighbour < numNeighbours; iNeighbour++)
+        {
+            if(harrisValues(iVertex) < harrisValues(neighbours[iNeighbour]))
             {
-                interestPoints->push_back(preSelectedSorted.at(i));
+                discard = true;
+                break;
             }
         }
-        return interestPoints;
+        if(!discard)
+        {
+            preSelected.push_back(iVertex);
+        }
     }
-    else
+    return preSelected;
+}
+
+/**
+ * @brief getNumPointsToChoose computes how many candidates a FRACTION selection keeps
+ * @param percentageOfPoints is a double indicating how many points should be considered as interest points
+ * @param numVertexes number of vertexes of the mesh
+ * @param numPreselected number of candidates, as returned by preselectInterestPoints
+ * @return the number of points to choose, all the candidates if the fraction is
+ *  0 or asks for more of them
+ */
+int Engine::getNumPointsToChoose(double percentageOfPoints, int numVertexes, int numPreselected)
+{
+    int numPointsToChoose = int(percentageOfPoints*numVertexes);
+    if(numPointsToChoose>numPreselected || numPointsToChoose == 0)
     {
-        return NULL;
+        numPointsToChoose = numPreselected;
     }
+    return numPointsToChoose;
+}
 
+/**
+ * @brief clusterInterestPoints accepts the candidates in order, discarding the
+ *  ones closer than rho to an already accepted point
+ * @param allVertexes matrix with all the vertexes of the mesh, as returned by getVertexesFromMesh
+ * @param sortedCandidates candidates sorted from the highest to the lowest Harris response
+ * @param rho minimum distance between interest points
+ * @param interestPoints receives the indexes of the accepted candidates
+ */
+void Engine::clusterInterestPoints(const Ref<const MatrixXd> & allVertexes, const vector<int> & sortedCandidates,
+                                   double rho, vector<int> & interestPoints)
+{
+    interestPoints.clear();
+    if( rho <= 0 )
+    {
+        //No distance is lower than rho, every candidate is accepted
+        interestPoints.assign(sortedCandidates.begin(), sortedCandidates.end());
+        return;
+    }
 
-    return NULL;
+    //Accepted points are stored in a grid of cells of side rho, so each
+    //candidate is only compared with the points of the neighbouring cells
+    SpatialGrid acceptedPoints(rho);
+    for( unsigned int i = 0 ; i < sortedCandidates.size() ; i++ )
+    {
+        Vector3d candidateVertex = allVertexes.row(sortedCandidates.at(i)).transpose();
+        if( !acceptedPoints.hasPointCloserThanRadius(candidateVertex) )
+        {
+            acceptedPoints.insert(candidateVertex);
+            interestPoints.push_back(sortedCandidates.at(i));
+        }
+    }
 }
 
 /**
@@ -179,18 +520,9 @@ vector<int> * Engine::findInterestPoints(
  */
 MatrixXd Engine::getVertexesFromMesh(Mesh * theMesh)
 {
-    int numPoints = theMesh->getAllVertexes()->size();
-    double * currVertex = NULL;
-    MatrixXd points(numPoints,3);
-    for(int iVertex=0; iVertex<numPoints; iVertex++)
-    {
-        currVertex = theMesh->getVertex(iVertex)->getCoordinates();
-        for(int j=0; j<3; j++)
-        {
-            points(iVertex,j) = currVertex[j];
-        }
-    }
-    return points;
+    // The coordinates are stored contiguously as rows X Y Z
+    return Map< Matrix<double, Dynamic, 3, RowMajor> >(
+        theMesh->getCoordinates(), theMesh->getNumVertexes(), 3);
 }
 
 /**
@@ -200,18 +532,9 @@ MatrixXd Engine::getVertexesFromMesh(Mesh * theMesh)
  */
 MatrixXi Engine::getFacesFromMesh(Mesh * theMesh)
 {
-    int numFaces = theMesh->getAllFaces()->size();
-    int * currFace = NULL;
-    MatrixXi faces(numFaces, 3);
-    for(int iFace=0; iFace<numFaces; iFace++)
-    {
-        currFace = theMesh->getFace(iFace)->getPointsInFace();
-        for(int j=0; j<3;j++)
-        {
-            faces(iFace, j) = currFace[j];
-        }
-    }
-    return faces;
+    // The indexes are stored contiguously as rows of 3 vertexes
+    return Map< Matrix<int, Dynamic, 3, RowMajor> >(
+        theMesh->getTriangles(), theMesh->getNumFaces(), 3);
 }
 
 /**
@@ -222,13 +545,8 @@ MatrixXi Engine::getFacesFromMesh(Mesh * theMesh)
  */
 VectorXi Engine::getFacesForVertex(Mesh * theMesh, int pointIndex)
 {
-    vector<int> facesForVertex = theMesh->getVertex(pointIndex)->getFaces();
-    VectorXi facesForThisVertex(facesForVertex.size());
-    for(unsigned int iF=0; iF<facesForVertex.size(); iF++)
-    {
-        facesForThisVertex(iF) = facesForVertex.at(iF);
-    }
-    return facesForThisVertex;
+    Adjacency * adjacency = theMesh->getAdjacency();
+    return Map<const VectorXi>(adjacency->getFaces(pointIndex), adjacency->getNumFaces(pointIndex));
 }
 
 /**
@@ -238,7 +556,7 @@ VectorXi Engine::getFacesForVertex(Mesh * theMesh, int pointIndex)
  * @param facesThatContainPoint is the vector that contains indexes of faces that contain vertex
  * @return Indexes of direct neighbours as a vector
  */
-VectorXi Engine::getDirectNeighbours(int iVertex, MatrixXi faces, VectorXi facesThatContainPoint)
+VectorXi Engine::getDirectNeighbours(int iVertex, const Ref<const MatrixXi> & faces, const Ref<const VectorXi> & facesThatContainPoint)
 {
     int numFacesWithVertex = facesThatContainPoint.size();
     set<int> directNeighbours;
@@ -263,57 +581,57 @@ VectorXi Engine::getDirectNeighbours(int iVertex, MatrixXi faces, VectorXi faces
     return vertexesFirstNeighbourhood;
 }
 
+/**
+ * @brief getDirectNeighbours finds the direct neighbours of a vertex
+ * @param vertex is the index of the vertex
+ * @param adjacency is the precomputed adjacency of the mesh
+ * @return Indexes of direct neighbours as a vector
+ */
+VectorXi Engine::getDirectNeighbours(int iVertex, Adjacency * adjacency)
+{
+    return Map<const VectorXi>(adjacency->getNeighbours(iVertex), adjacency->getNumNeighbours(iVertex));
+}
+
+/**
+ * @brief getRings gets neighbourhood k for point with index vertex. Kept for
+ *  compatibility, the overload that takes the adjacency does the work.
+ * @param vertex is the index of the vertex
+ * @param k is the depth of the ring neighbourhood
+ * @param faces is the matrix of faces, not used: the adjacency of theMesh
+ *  describes the same topology
+ * @param firstNeighbours is a vector containing the indexes of the direct neighbours, not used
+ * @param theMesh is the mesh or surface being analyzed (read and sent from middleware),
+ *  whose adjacency is used to walk the rings
+ * @return a vector with indexes of neighbours until depth k (includes all points within ring k and also ring k)
+ */
+VectorXi Engine::getRings(int vertex, int k, const Ref<const MatrixXi> &, const Ref<const VectorXi> &, Mesh * theMesh)
+{
+    return this->getRings(vertex, k, theMesh->getAdjacency());
+}
+
 /**
  * @brief getRings gets neighbourhood k for point with index vertex
  * @param vertex is the index of the vertex
  * @param k is the depth of the ring neighbourhood
- * @param faces is the matrix of faces
- * @param firstNeighbours is a vector containing the indexes of the direct neighbours
- * @param theMesh is the mesh or surface being analyzed (read and sent from middleware)
+ * @param adjacency is the precomputed adjacency of the mesh
  * @return a vector with indexes of neighbours until depth k (includes all points within ring k and also ring k)
  */
-VectorXi Engine::getRings(int vertex, int k, MatrixXi faces, VectorXi firstNeighbours, Mesh * theMesh)
+VectorXi Engine::getRings(int vertex, int k, Adjacency * adjacency)
 {
-    set <int> s0;
-    s0.insert(vertex);
-    set <int> s1;
-    set <int> sAccum;
-    for(int iNei=0;iNei<firstNeighbours.size(); iNei++)
-    {
-        s1.insert(firstNeighbours(iNei));
-    }
-    set <int> result = s0;
-    result.insert(s1.begin(), s1.end());
-    set <int> tempSet1;
-    set <int> tempSet2;
-    for(int ring=2; ring<k; ring++)
-    {
-        for (set<int>::iterator it=s1.begin(); it!=s1.end(); ++it)
-        {
-            VectorXi facesThatContainPoint = this->getFacesForVertex(theMesh, *it);
-            VectorXi someNeighbours = this->getDirectNeighbours(*it, faces, facesThatContainPoint);
-            for(int i=0; i<someNeighbours.size(); i++)
-            {
-                sAccum.insert(someNeighbours(i));
-                result.insert(someNeighbours(i));
-            }
-        }
-        set_difference(sAccum.begin(), sAccum.end(), s1.begin(), s1.end(), inserter(tempSet1, tempSet1.end()));
-        set_difference(tempSet1.begin(), tempSet1.end(), s0.begin(), s0.end(), inserter(tempSet2, tempSet2.end()));
-        s0 = s1;
-        s1 = tempSet2;
-        tempSet1.clear();
-        tempSet2.clear();
-    }
-    int kNeighboursSize = result.size();
-    VectorXi kNeighbours(kNeighboursSize);
-    int ctrlVar1(0);
-    for (set<int>::iterator it=result.begin(); it!=result.end(); ++it)
-    {
-        kNeighbours(ctrlVar1) = *it;
-        ctrlVar1++;
-    }
-    return kNeighbours;
+    static thread_local RingGatherer gatherer;
+    return gatherer.gather(vertex, this->getRingDepth(k), adjacency);
+}
+
+/**
+ * @brief getRingDepth converts the number of rings into the maximum distance
+ *  in edges of the neighbourhood. The vertex itself counts as the first ring,
+ *  and the direct neighbours are always included.
+ * @param k is the number of rings
+ * @return the maximum distance in edges to the analysed vertex
+ */
+int Engine::getRingDepth(int k)
+{
+    return std::max(1, k - 1);
 }
 
 /**
@@ -322,12 +640,12 @@ VectorXi Engine::getRings(int vertex, int k, MatrixXi faces, VectorXi firstNeigh
  * @param theMesh is the mesh or surface being analyzed (read and sent from middleware)
  * @return Matrix with points corresponding to given indexes
  */
-MatrixXd Engine::getVertexesFromIndexes(VectorXi indexes, Mesh * theMesh)
+MatrixXd Engine::getVertexesFromIndexes(const Ref<const VectorXi> & indexes, Mesh * theMesh)
 {
     MatrixXd points(indexes.size(), 3);
     for(int iP=0; iP<indexes.size(); iP++)
     {
-        double * xyz =  theMesh->getVertex(indexes(iP))->getCoordinates();
+        double * xyz =  theMesh->getCoordinates() + 3 * indexes(iP);
         points(iP, 0) = xyz[0];
         points(iP, 1) = xyz[1];
         points(iP, 2) = xyz[2];
@@ -335,6 +653,22 @@ MatrixXd Engine::getVertexesFromIndexes(VectorXi indexes, Mesh * theMesh)
     return points;
 }
 
+/**
+ * @brief getVertexesFromIndexes gets matrix with vertexes corresponding to specific indexes
+ * @param indexes indexes of vertexes
+ * @param allVertexes matrix with all the vertexes of the mesh, as returned by getVertexesFromMesh
+ * @return Matrix with points corresponding to given indexes
+ */
+MatrixXd Engine::getVertexesFromIndexes(const Ref<const VectorXi> & indexes, const Ref<const MatrixXd> & allVertexes)
+{
+    MatrixXd points(indexes.size(), 3);
+    for(int iP=0; iP<indexes.size(); iP++)
+    {
+        points.row(iP) = allVertexes.row(indexes(iP));
+    }
+    return points;
+}
+
 /**
  * @brief getVertexFromMeshAsVector3d Gets a vertex as a vector from its position or index
  * @param position is the index of the vertex that is required
@@ -343,7 +677,7 @@ MatrixXd Engine::getVertexesFromIndexes(VectorXi indexes, Mesh * theMesh)
  */
 Vector3d Engine::getVertexFromMeshAsVector3d(int position, Mesh * theMesh)
 {
-    double * xyz = theMesh->getVertex(position)->getCoordinates();
+    double * xyz = theMesh->getCoordinates() + 3 * position;
     Vector3d vertexVector;
     vertexVector(0) = xyz[0];
     vertexVector(1) = xyz[1];
@@ -357,7 +691,7 @@ Vector3d Engine::getVertexFromMeshAsVector3d(int position, Mesh * theMesh)
  * @param indexesOfNeighbours is the vector with the indexes of the neighbours
  * @return index of vertexIndex in indexOfNeighbours
  */
-int Engine::getVertexIndexInNeighbourhood(int vertexIndex, VectorXi indexesOfNeighbours)
+int Engine::getVertexIndexInNeighbourhood(int vertexIndex, const Ref<const VectorXi> & indexesOfNeighbours)
 {
     int indexOfVertex(0);
     for(int i=0; i<indexesOfNeighbours.size(); i++)
@@ -379,7 +713,7 @@ int Engine::getVertexIndexInNeighbourhood(int vertexIndex, VectorXi indexesOfNei
  * @param Neighbourhood
  * @return
  */
-MatrixXd Engine::centerNeighbourhood(MatrixXd Neighbourhood , MatrixXd& Centroid )
+MatrixXd Engine::centerNeighbourhood(const Ref<const MatrixXd> & Neighbourhood , MatrixXd& Centroid )
 {
     // Calculate the mean of all the values in the colums of the neibourghood
     Centroid = Neighbourhood.colwise().sum() / Neighbourhood.rows();
@@ -399,7 +733,7 @@ MatrixXd Engine::centerNeighbourhood(MatrixXd Neighbourhood , MatrixXd& Centroid
  * @param CenteredNeighbourhood
  * @return
  */
-MatrixXd Engine::rotateToFitPlane(MatrixXd centeredPoints, int analizedPointIndex)
+MatrixXd Engine::rotateToFitPlane(const Ref<const MatrixXd> & centeredPoints, int analizedPointIndex)
 {
     // As we centered the data before applying the PCA algorithm the covariance
     // matrix can be calculated applying Cxy=P.t()*P;
@@ -436,6 +770,46 @@ MatrixXd Engine::rotateToFitPlane(MatrixXd centeredPoints, int analizedPointInde
 }
 
 
+/**
+ * @brief computeRotationToFitPlane:
+ *        Same Principal Component Analysis as rotateToFitPlane, but the
+ *        3x3 covariance matrix is accumulated in one pass and decomposed
+ *        with the closed-form solver. Only the rotation is returned, the
+ *        points are not rotated.
+ * @param centeredPoints : the centrated points of the Neibourhood
+ * @param analizedPointIndex  : the vertex of analisys
+ * @return the rotation matrix that maps the points to the fitting plane
+ */
+Matrix3d Engine::computeRotationToFitPlane(const Ref<const MatrixXd> & centeredPoints, int analizedPointIndex)
+{
+    // Cxy=P.t()*P accumulated point by point in a fixed size matrix
+    Matrix3d covarianceMatrix = Matrix3d::Zero();
+    for( int i = 0 ; i < centeredPoints.rows() ; i++ )
+    {
+        Vector3d point = centeredPoints.row(i).transpose();
+        covarianceMatrix.noalias() += point * point.transpose();
+    }
+
+    // computeDirect also returns the eigenvalues in increasing order
+    SelfAdjointEigenSolver<Matrix3d> covarianceDescomposition;
+    covarianceDescomposition.computeDirect(covarianceMatrix);
+    const Matrix3d & eigenVectorsIncreasing = covarianceDescomposition.eigenvectors();
+    Matrix3d eigenVectors = eigenVectorsIncreasing.rowwise().reverse();
+
+    // Same right hand check as rotateToFitPlane
+    Vector3d analizedPoint = centeredPoints.row(analizedPointIndex).transpose();
+    double normalDirection = analizedPoint.dot(eigenVectorsIncreasing.row(2).transpose());
+
+    Matrix3d rotationMatrix = eigenVectors;
+    if( normalDirection < 0 )
+    {
+        rotationMatrix = -eigenVectors;
+        rotationMatrix.col(0) = eigenVectors.col(1);
+        rotationMatrix.col(1) = eigenVectors.col(0);
+    }
+    return rotationMatrix;
+}
+
 /**
  * @brief fitQuadraticSurface
  *        Apply Least Squares to fit a quadratic surface to the rotated
@@ -444,7 +818,7 @@ MatrixXd Engine::rotateToFitPlane(MatrixXd centeredPoints, int analizedPointInde
  * @param analizedPointIndex  : the vertex of analisys
  * @return
  */
-MatrixXd Engine::fitQuadraticSurface(MatrixXd rotatedPoints, int analizedPointIndex)
+MatrixXd Engine::fitQuadraticSurface(const Ref<const MatrixXd> & rotatedPoints, int analizedPointIndex)
 {
     MatrixXd analizedPoint = rotatedPoints.row(analizedPointIndex);
     analizedPoint(0,2) = 0;
@@ -469,13 +843,92 @@ MatrixXd Engine::fitQuadraticSurface(MatrixXd rotatedPoints, int analizedPointIn
     return X;
 }
 
+/**
+ * @brief fitQuadraticSurfaceNormalEquations
+ *        Apply Least Squares to fit a quadratic surface to the rotated
+ *        points of the Neighbourhood, accumulating the 6x6 normal
+ *        equations in fixed size matrices and solving them with LDLT.
+ *        Ill-conditioned systems are solved with a complete orthogonal
+ *        decomposition instead.
+ * @param rotatedPoints     : the rotated points of the Neighbourhood
+ * @return the parameters of the Quadratic Surface, as fitQuadraticSurface
+ */
+Matrix<double, 6, 1> Engine::fitQuadraticSurfaceNormalEquations(const Ref<const MatrixXd> & rotatedPoints)
+{
+    return this->fitQuadraticSurfaceNormalEquations(rotatedPoints, Matrix3d::Identity());
+}
+
+/**
+ * @brief fitQuadraticSurfaceNormalEquations
+ *        Same fitting as above, rotating every centered point on the fly
+ *        instead of reading already rotated points.
+ * @param centeredPoints : the centrated points of the Neighbourhood
+ * @param rotation : the rotation returned by computeRotationToFitPlane
+ * @return the parameters of the Quadratic Surface, as fitQuadraticSurface
+ */
+Matrix<double, 6, 1> Engine::fitQuadraticSurfaceNormalEquations(
+    const Ref<const MatrixXd> & centeredPoints, const Matrix3d & rotation)
+{
+    // Scale x and y to the unit range, so the entries of the normal matrix
+    // do not span too many orders of magnitude
+    double scale = 0;
+    for( int i = 0 ; i < centeredPoints.rows() ; i++ )
+    {
+        RowVector3d rotated = centeredPoints.row(i) * rotation;
+        scale = std::max(scale, std::max(std::abs(rotated(0)), std::abs(rotated(1))));
+    }
+    if( scale <= 0 )
+    {
+        scale = 1;
+    }
+
+    // Accumulate A.t()*A and A.t()*b for the rows of A:
+    // [x*x x*y y*y x y 1] X = z
+    Matrix<double, 6, 6> normalMatrix = Matrix<double, 6, 6>::Zero();
+    Matrix<double, 6, 1> rightHandSide = Matrix<double, 6, 1>::Zero();
+    Matrix<double, 6, 1> row;
+    for( int i = 0 ; i < centeredPoints.rows() ; i++ )
+    {
+        RowVector3d rotated = centeredPoints.row(i) * rotation;
+        double x = rotated(0) / scale;
+        double y = rotated(1) / scale;
+        row << x*x, x*y, y*y, x, y, 1;
+        normalMatrix.noalias() += row * row.transpose();
+        rightHandSide += row * rotated(2);
+    }
+
+    Matrix<double, 6, 1> X;
+    LDLT< Matrix<double, 6, 6> > decomposition(normalMatrix);
+    if( decomposition.info() == Success && decomposition.isPositive()
+        && decomposition.rcond() > 1e-12 )
+    {
+        X = decomposition.solve(rightHandSide);
+    }
+    else
+    {
+        X = normalMatrix.completeOrthogonalDecomposition().solve(rightHandSide);
+    }
+
+    // Undo the scaling of x and y
+    X(0) = X(0) / (scale * scale);
+    X(1) = X(1) / (scale * scale);
+    X(2) = X(2) / (scale * scale);
+    X(3) = X(3) / scale;
+    X(4) = X(4) / scale;
+
+    // X = [p1/2 p2 p3/2 p4 p5 p6] , so  we multiply X(0) and X(2) by 2
+    X(0) = X(0) * 2;
+    X(2) = X(2) * 2;
+    return X;
+}
+
 /**
  * @brief findderivativeEmatrix formulates the derivative matrix for
  *        the harris operator
  * @param X : the parameters of the Quadratic Surface.
  * @return
  */
-MatrixXd Engine::findderivativeEmatrix(MatrixXd X)
+MatrixXd Engine::findderivativeEmatrix(const Ref<const MatrixXd> & X)
 {
     // Recover the parameter to perfor equation 10-12 of the paper
     double p1, p2, p3, p4, p5;
@@ -505,22 +958,73 @@ MatrixXd Engine::findderivativeEmatrix(MatrixXd X)
  * @param k Paramter for Harris operator calculation according to formula (3)
  * @return Value of Harris operator according to equation (3)
  */
-double Engine::computeHarris(MatrixXd E, double k)
+double Engine::computeHarris(const Ref<const MatrixXd> & E, double k)
+{
+    return this->computeHarris(E(0,0), E(1,1), E(0,1), k);
+}
+
+/**
+ * @brief computeHarris computes the Harris operator for the current point
+ * @param A Element (0,0) of the matrix E obtained from surface fitting
+ * @param B Element (1,1) of the matrix E
+ * @param C Elements (0,1) and (1,0) of the matrix E
+ * @param k Paramter for Harris operator calculation according to formula (3)
+ * @return Value of Harris operator according to equation (3)
+ */
+double Engine::computeHarris(double A, double B, double C, double k)
 {
-    double A = E(0,0);
-    double C = E(0,1);
-    double B = E(1,1);
     double harrisOperator = (A*B - C*C) - k*(A+B)*(A+B); //det(E) - k*(tr(E))^2
     return harrisOperator;
 }
 
+/**
+ * @brief sortByHarrisResponse moves the count vertexes with the highest Harris
+ *  response to the front of vertexIndexes, sorted by decreasing response. Ties
+ *  are broken by increasing vertex index, and NaN responses are considered
+ *  lower than any other. The order of the remaining vertexes is unspecified.
+ * @param vertexIndexes indexes of the vertexes to sort
+ * @param harrisValues Harris response of every vertex of the mesh
+ * @param count number of vertexes to place at the front
+ */
+void Engine::sortByHarrisResponse(vector<int> & vertexIndexes, const Ref<const VectorXd> & harrisValues, int count)
+{
+    ProfileTimer timer(profile, STAGE_SORT);
+    count = std::max(0, std::min(count, int(vertexIndexes.size())));
+    auto isHigher = [&harrisValues](int a, int b)
+    {
+        double valueA = harrisValues(a);
+        double valueB = harrisValues(b);
+        if( std::isnan(valueA) || std::isnan(valueB) )
+        {
+            if( std::isnan(valueA) != std::isnan(valueB) )
+            {
+                return std::isnan(valueB);
+            }
+            return a < b;
+        }
+        if( valueA != valueB )
+        {
+            return valueA > valueB;
+        }
+        return a < b;
+    };
+    std::partial_sort(vertexIndexes.begin(), vertexIndexes.begin() + count, vertexIndexes.end(), isHigher);
+}
+
 /**
  * @brief getDiagonalOfMesh computes the diagonal lenght of the points in the mesh
  * @param vertexes A matrix containing all the vertex of the mesh
- * @return the distance between the lowest and the maximum point int the mesh
+ * @return the distance between the lowest and the maximum point int the mesh,
+ *  0 if the mesh has no vertexes
  */
-double Engine::getDiagonalOfMesh(MatrixXd allVertexes)
+double Engine::getDiagonalOfMesh(const Ref<const MatrixXd> & allVertexes)
 {
+    //The coefficients of an empty matrix are not defined
+    if(allVertexes.rows() == 0)
+    {
+        return 0;
+    }
+
     // Get maximum and minimum values of the objects in the mesh
     double maxX = allVertexes.col(0).maxCoeff();
     double minX = allVertexes.col(0).minCoeff();
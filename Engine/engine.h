@@ -2,6 +2,11 @@
 #define ENGINE_H
 
 #include "BasicStructures/mesh.h"
+#include "Engine/jobcontrol.h"
+#include "Engine/parallel.h"
+#include "Engine/ringgatherer.h"
+#include "Engine/spatialgrid.h"
+#include "Engine/stageprofile.h"
 #include <Eigen/Dense>
 #include <Eigen/Core>
 #include <vector>
@@ -14,18 +19,130 @@ using namespace Eigen;
 
 enum SelectionMode{FRACTION, CLUSTERING};
 
+/**
+ * @brief HarrisCoefficients coefficients A, B, C of the matrix E of every
+ *  vertex, one vertex per row
+ */
+typedef Matrix<double, Dynamic, 3, RowMajor> HarrisCoefficients;
+
+/**
+ * @brief The ParameterGrid struct lists the values of every parameter of a
+ *  sweep, which runs every combination of them
+ */
+struct ParameterGrid
+{
+    vector<int> numRings;
+    vector<double> k;
+    vector<double> percentageOfPoints;
+    vector<SelectionMode> selectionModes;
+};
+
+/**
+ * @brief The SweepCase struct is a combination of parameters of a sweep. Its
+ *  interest points are SweepTable::interestPoints[firstPoint] ..
+ *  SweepTable::interestPoints[firstPoint + numPoints - 1]
+ */
+struct SweepCase
+{
+    int numRings;
+    double k;
+    double percentageOfPoints;
+    SelectionMode selectionMode;
+    int firstPoint;
+    int numPoints;
+};
+
+/**
+ * @brief The SweepTable struct is the result of a sweep: every combination of
+ *  parameters and the interest points of all of them in a single array
+ */
+struct SweepTable
+{
+    vector<SweepCase> cases;
+    vector<int> interestPoints;
+};
+
 
 /**
  * @brief The Engine class for managing all computations related to the Harris operator
  */
 class Engine
 {
+private:
+    /**
+     * @brief numThreads Number of threads used to compute the Harris response
+     *  of the vertexes. 1 runs the computation serially.
+     */
+    int numThreads;
+
+    /**
+     * @brief coefficients A, B, C of every vertex of the mesh with revision
+     *  coefficientsRevision, using coefficientsRings rings. A revision of 0
+     *  means that no coefficients are kept.
+     */
+    HarrisCoefficients coefficients;
+    unsigned long long coefficientsRevision;
+    int coefficientsRings;
+
+    /**
+     * @brief control of the job being computed, NULL if there is none
+     */
+    JobControl * control;
+
+    /**
+     * @brief profile receives the time of every stage of the computations,
+     *  NULL if they are not timed
+     */
+    StageProfile * profile;
+
 public:
     /**
      * @brief Engine Default constructor for class Engine
      */
     Engine();
 
+    /**
+     * @brief setNumThreads defines the number of threads used to compute the
+     *  Harris response of the vertexes. The result does not depend on it.
+     * @param numThreads number of threads, 0 or less uses all the hardware threads
+     */
+    void setNumThreads(int numThreads);
+
+    /**
+     * @brief getNumThreads
+     * @return the number of threads used to compute the Harris response
+     */
+    int getNumThreads();
+
+    /**
+     * @brief setJobControl defines the control of the next computations. The
+     *  computation of the coefficients reports its progress to it and stops
+     *  early if it is cancelled, leaving no coefficients kept.
+     * @param control the control, or NULL to run without one
+     */
+    void setJobControl(JobControl * control);
+
+    /**
+     * @brief isCancelled
+     * @return true if the control of the computations has been cancelled,
+     *  in which case their results must be discarded
+     */
+    bool isCancelled();
+
+    /**
+     * @brief setProfile defines the profile that accumulates the wall time and
+     *  the number of calls of every stage of the next computations, per thread.
+     *  It is not reset, so several queries can be added up.
+     * @param profile the profile, or NULL to run without timing the stages
+     */
+    void setProfile(StageProfile * profile);
+
+    /**
+     * @brief getProfile
+     * @return the profile of the computations, NULL if they are not timed
+     */
+    StageProfile * getProfile();
+
     /**
      * @brief findInterestPoints Method for finding interest points for a mesh
      * @param theMesh Mesh sent by communicator for computing interest points
@@ -34,10 +151,100 @@ public:
      * @param percentageOfPoints is a double indicating how many points should be considered as interest points
      * @param selectionMode is an enumeration item defining the type of selection for the interest points
      * @return vector of integers with indixes of vertexes that are of interest
+     *  (NULL if the job control is cancelled)
      */
     vector<int> * findInterestPoints(
         Mesh * theMesh, int numRings, double k, double percentageOfPoints, SelectionMode selectionMode);
 
+    /**
+     * @brief computeHarrisResponses computes the Harris operator of every vertex of a mesh
+     * @param theMesh Mesh sent by communicator for computing interest points
+     * @param numRings Number of rings to be considered for the computation of neighbourhood
+     * @param k Constant for Harris operator computation (Equation 3 in paper)
+     * @return vector with the value of the Harris operator of every vertex
+     */
+    VectorXd computeHarrisResponses(Mesh * theMesh, int numRings, double k);
+
+    /**
+     * @brief computeCoefficients computes the coefficients A, B, C of the matrix E
+     *  of every vertex of a mesh, which are all the Harris operator needs. They are
+     *  kept until the mesh changes or another mesh or number of rings is used, so
+     *  that queries that only change k or the selection do not compute them again.
+     * @param theMesh Mesh sent by communicator for computing interest points
+     * @param numRings Number of rings to be considered for the computation of neighbourhood
+     * @return matrix with the coefficients A, B, C of every vertex in its rows
+     */
+    const HarrisCoefficients & computeCoefficients(Mesh * theMesh, int numRings);
+
+    /**
+     * @brief hasCoefficients checks if the coefficients of a mesh are already computed
+     * @param theMesh Mesh sent by communicator for computing interest points
+     * @param numRings Number of rings to be considered for the computation of neighbourhood
+     * @return true if computeCoefficients would return them without computing them
+     */
+    bool hasCoefficients(Mesh * theMesh, int numRings);
+
+    /**
+     * @brief clearCoefficients releases the coefficients kept by computeCoefficients
+     */
+    void clearCoefficients();
+
+    /**
+     * @brief selectInterestPoints selects the interest points of a mesh from the
+     *  Harris operator of its vertexes
+     * @param theMesh Mesh sent by communicator for computing interest points
+     * @param harrisValues Harris operator of every vertex, as returned by computeHarrisResponses
+     * @param percentageOfPoints is a double indicating how many points should be considered as interest points
+     * @param selectionMode is an enumeration item defining the type of selection for the interest points
+     * @return vector of integers with indixes of vertexes that are of interest
+     */
+    vector<int> * selectInterestPoints(
+        Mesh * theMesh, const Ref<const VectorXd> & harrisValues, double percentageOfPoints, SelectionMode selectionMode);
+
+    /**
+     * @brief sweepParameters finds the interest points of a mesh for every
+     *  combination of the values of a parameter grid. The coefficients of the
+     *  vertexes are computed once per number of rings, and the Harris response,
+     *  the pre-selection and the sorting of the candidates once per value of k;
+     *  every percentage and selection mode only selects from those candidates.
+     * @param theMesh Mesh sent by communicator for computing interest points
+     * @param grid values of every parameter
+     * @return table with the interest points of every combination, in the order
+     *  numRings, k, percentageOfPoints, selectionMode, the last one changing fastest.
+     *  NULL if the job control is cancelled.
+     */
+    SweepTable * sweepParameters(Mesh * theMesh, const ParameterGrid & grid);
+
+    /**
+     * @brief preselectInterestPoints finds the vertexes whose Harris response is
+     *  not lower than the one of any of their direct neighbours
+     * @param theMesh Mesh sent by communicator for computing interest points
+     * @param harrisValues Harris operator of every vertex, as returned by computeHarrisResponses
+     * @return indexes of the candidates, in increasing order
+     */
+    vector<int> preselectInterestPoints(Mesh * theMesh, const Ref<const VectorXd> & harrisValues);
+
+    /**
+     * @brief getNumPointsToChoose computes how many candidates a FRACTION selection keeps
+     * @param percentageOfPoints is a double indicating how many points should be considered as interest points
+     * @param numVertexes number of vertexes of the mesh
+     * @param numPreselected number of candidates, as returned by preselectInterestPoints
+     * @return the number of points to choose, all the candidates if the fraction is
+     *  0 or asks for more of them
+     */
+    int getNumPointsToChoose(double percentageOfPoints, int numVertexes, int numPreselected);
+
+    /**
+     * @brief clusterInterestPoints accepts the candidates in order, discarding the
+     *  ones closer than rho to an already accepted point
+     * @param allVertexes matrix with all the vertexes of the mesh, as returned by getVertexesFromMesh
+     * @param sortedCandidates candidates sorted from the highest to the lowest Harris response
+     * @param rho minimum distance between interest points
+     * @param interestPoints receives the indexes of the accepted candidates
+     */
+    void clusterInterestPoints(const Ref<const MatrixXd> & allVertexes, const vector<int> & sortedCandidates,
+                               double rho, vector<int> & interestPoints);
+
     /**
      * @brief getVertexesFromMesh converts vector of vertexes of theMesh into an MatrixXd
      * @param theMesh is the mesh or surface being analyzed (read and sent from middleware)
@@ -67,18 +274,47 @@ public:
      * @param facesThatContainPoint is the vector that contains indexes of faces that contain vertex
      * @return Indexes of direct neighbours as a vector
      */
-    VectorXi getDirectNeighbours(int vertex, MatrixXi faces, VectorXi facesThatContainPoint);
+    VectorXi getDirectNeighbours(int vertex, const Ref<const MatrixXi> & faces, const Ref<const VectorXi> & facesThatContainPoint);
+
+    /**
+     * @brief getDirectNeighbours finds the direct neighbours of a vertex
+     * @param vertex is the index of the vertex
+     * @param adjacency is the precomputed adjacency of the mesh
+     * @return Indexes of direct neighbours as a vector
+     */
+    VectorXi getDirectNeighbours(int vertex, Adjacency * adjacency);
+
+    /**
+     * @brief getRings gets neighbourhood k for point with index vertex. Kept for
+     *  compatibility, the overload that takes the adjacency does the work.
+     * @param vertex is the index of the vertex
+     * @param k is the depth of the ring neighbourhood
+     * @param faces is the matrix of faces, not used: the adjacency of theMesh
+     *  describes the same topology
+     * @param firstNeighbours is a vector containing the indexes of the direct neighbours, not used
+     * @param theMesh is the mesh or surface being analyzed (read and sent from middleware),
+     *  whose adjacency is used to walk the rings
+     * @return a vector with indexes of neighbours until depth k (includes all points within ring k and also ring k)
+     */
+    VectorXi getRings(int vertex, int k, const Ref<const MatrixXi> & faces, const Ref<const VectorXi> & firstNeighbours, Mesh * theMesh);
 
     /**
      * @brief getRings gets neighbourhood k for point with index vertex
      * @param vertex is the index of the vertex
      * @param k is the depth of the ring neighbourhood
-     * @param faces is the matrix of faces
-     * @param firstNeighbours is a vector containing the indexes of the direct neighbours
-     * @param theMesh is the mesh or surface being analyzed (read and sent from middleware)
+     * @param adjacency is the precomputed adjacency of the mesh
      * @return a vector with indexes of neighbours until depth k (includes all points within ring k and also ring k)
      */
-    VectorXi getRings(int vertex, int k, MatrixXi faces, VectorXi firstNeighbours, Mesh * theMesh);
+    VectorXi getRings(int vertex, int k, Adjacency * adjacency);
+
+    /**
+     * @brief getRingDepth converts the number of rings into the maximum distance
+     *  in edges of the neighbourhood. The vertex itself counts as the first ring,
+     *  and the direct neighbours are always included.
+     * @param k is the number of rings
+     * @return the maximum distance in edges to the analysed vertex
+     */
+    int getRingDepth(int k);
 
     /**
      * @brief getVertexesFromIndexes gets matrix with vertexes corresponding to specific indexes
@@ -86,7 +322,15 @@ public:
      * @param theMesh is the mesh or surface being analyzed (read and sent from middleware)
      * @return Matrix with points corresponding to given indexes
      */
-    MatrixXd getVertexesFromIndexes(VectorXi indexes, Mesh * theMesh);
+    MatrixXd getVertexesFromIndexes(const Ref<const VectorXi> & indexes, Mesh * theMesh);
+
+    /**
+     * @brief getVertexesFromIndexes gets matrix with vertexes corresponding to specific indexes
+     * @param indexes indexes of vertexes
+     * @param allVertexes matrix with all the vertexes of the mesh, as returned by getVertexesFromMesh
+     * @return Matrix with points corresponding to given indexes
+     */
+    MatrixXd getVertexesFromIndexes(const Ref<const VectorXi> & indexes, const Ref<const MatrixXd> & allVertexes);
 
     /**
      * @brief getVertexFromMeshAsVector3d Gets a vertex as a vector from its position or index
@@ -102,7 +346,7 @@ public:
      * @param indexesOfNeighbours is the vector with the indexes of the neighbours
      * @return index of vertexIndex in indexOfNeighbours
      */
-    int getVertexIndexInNeighbourhood(int vertexIndex, VectorXi indexesOfNeighbours);
+    int getVertexIndexInNeighbourhood(int vertexIndex, const Ref<const VectorXi> & indexesOfNeighbours);
 
     /**
      * @brief centerNeighbourhood :
@@ -111,7 +355,7 @@ public:
      * @param Neighbourhood
      * @return
      */
-    MatrixXd centerNeighbourhood(MatrixXd Neighbourhood , MatrixXd& Centroid );
+    MatrixXd centerNeighbourhood(const Ref<const MatrixXd> & Neighbourhood , MatrixXd& Centroid );
 
     /**
      * @brief rotationToFitPlane:
@@ -122,7 +366,19 @@ public:
      * @param analizedPointIndex  : the vertex of analisys
      * @return
      */
-    MatrixXd rotateToFitPlane(MatrixXd centeredPoints, int analizedPointIndex);
+    MatrixXd rotateToFitPlane(const Ref<const MatrixXd> & centeredPoints, int analizedPointIndex);
+
+    /**
+     * @brief computeRotationToFitPlane:
+     *        Same Principal Component Analysis as rotateToFitPlane, but the
+     *        3x3 covariance matrix is accumulated in one pass and decomposed
+     *        with the closed-form solver. Only the rotation is returned, the
+     *        points are not rotated.
+     * @param centeredPoints : the centrated points of the Neibourhood
+     * @param analizedPointIndex  : the vertex of analisys
+     * @return the rotation matrix that maps the points to the fitting plane
+     */
+    Matrix3d computeRotationToFitPlane(const Ref<const MatrixXd> & centeredPoints, int analizedPointIndex);
 
     /**
      * @brief fitQuadraticSurface
@@ -132,7 +388,30 @@ public:
      * @param analizedPointIndex  : the vertex of analisys
      * @return
      */
-    MatrixXd fitQuadraticSurface(MatrixXd rotatedPoints, int analizedPointIndex);
+    MatrixXd fitQuadraticSurface(const Ref<const MatrixXd> & rotatedPoints, int analizedPointIndex);
+
+    /**
+     * @brief fitQuadraticSurfaceNormalEquations
+     *        Apply Least Squares to fit a quadratic surface to the rotated
+     *        points of the Neighbourhood, accumulating the 6x6 normal
+     *        equations in fixed size matrices and solving them with LDLT.
+     *        Ill-conditioned systems are solved with a complete orthogonal
+     *        decomposition instead.
+     * @param rotatedPoints     : the rotated points of the Neighbourhood
+     * @return the parameters of the Quadratic Surface, as fitQuadraticSurface
+     */
+    Matrix<double, 6, 1> fitQuadraticSurfaceNormalEquations(const Ref<const MatrixXd> & rotatedPoints);
+
+    /**
+     * @brief fitQuadraticSurfaceNormalEquations
+     *        Same fitting as above, rotating every centered point on the fly
+     *        instead of reading already rotated points.
+     * @param centeredPoints : the centrated points of the Neighbourhood
+     * @param rotation : the rotation returned by computeRotationToFitPlane
+     * @return the parameters of the Quadratic Surface, as fitQuadraticSurface
+     */
+    Matrix<double, 6, 1> fitQuadraticSurfaceNormalEquations(
+        const Ref<const MatrixXd> & centeredPoints, const Matrix3d & rotation);
 
 
     /**
@@ -141,7 +420,7 @@ public:
      * @param X : the parameters of the Quadratic Surface.
      * @return
      */
-    MatrixXd findderivativeEmatrix(MatrixXd X);
+    MatrixXd findderivativeEmatrix(const Ref<const MatrixXd> & X);
 
     /**
      * @brief computeHarris computes the Harris operator for the current point
@@ -149,16 +428,38 @@ public:
      * @param k Paramter for Harris operator calculation according to formula (3)
      * @return Value of Harris operator according to equation (3)
      */
-    double computeHarris(MatrixXd E, double k);
+    double computeHarris(const Ref<const MatrixXd> & E, double k);
+
+    /**
+     * @brief computeHarris computes the Harris operator for the current point
+     * @param A Element (0,0) of the matrix E obtained from surface fitting
+     * @param B Element (1,1) of the matrix E
+     * @param C Elements (0,1) and (1,0) of the matrix E
+     * @param k Paramter for Harris operator calculation according to formula (3)
+     * @return Value of Harris operator according to equation (3)
+     */
+    double computeHarris(double A, double B, double C, double k);
 
     //Here select interest points according to highest Harris operator or clustering
 
+    /**
+     * @brief sortByHarrisResponse moves the count vertexes with the highest Harris
+     *  response to the front of vertexIndexes, sorted by decreasing response. Ties
+     *  are broken by increasing vertex index, and NaN responses are considered
+     *  lower than any other. The order of the remaining vertexes is unspecified.
+     * @param vertexIndexes indexes of the vertexes to sort
+     * @param harrisValues Harris response of every vertex of the mesh
+     * @param count number of vertexes to place at the front
+     */
+    void sortByHarrisResponse(vector<int> & vertexIndexes, const Ref<const VectorXd> & harrisValues, int count);
+
     /**
      * @brief getDiagonalOfMesh computes the diagonal lenght of the points in the mesh
      * @param vertexes A matrix containing all the vertex of the mesh
-     * @return the distance between the lowest and the maximum point int the mesh
+     * @return the distance between the lowest and the maximum point int the mesh,
+     *  0 if the mesh has no vertexes
      */
-    double getDiagonalOfMesh(MatrixXd allVertexes);
+    double getDiagonalOfMesh(const Ref<const MatrixXd> & allVertexes);
 
 };
 
@@ -0,0 +1,93 @@
+#include "Engine/jobcontrol.h"
+
+/**
+ * @brief JobControl::JobControl creates a control of a job that has not started
+ */
+JobControl::JobControl()
+    : cancelled(false), numDone(0), numSteps(0), lastReported(0)
+{
+}
+
+/**
+ * @brief JobControl::setProgressCallback defines a function called every time
+ *  the progress grows by at least 1%. It is called from the threads of the
+ *  computation, so it must be thread safe and return quickly.
+ * @param progressCallback function that receives the progress, from 0 to 1
+ */
+void JobControl::setProgressCallback(const std::function<void(double)> & progressCallback)
+{
+    this->progressCallback = progressCallback;
+}
+
+/**
+ * @brief JobControl::cancel asks the computation to stop as soon as possible
+ */
+void JobControl::cancel()
+{
+    cancelled = true;
+}
+
+/**
+ * @brief JobControl::isCancelled
+ * @return true if cancel has been called
+ */
+bool JobControl::isCancelled() const
+{
+    return cancelled.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief JobControl::startStage resets the progress for a new stage of the computation
+ * @param numSteps number of steps of the stage
+ */
+void JobControl::startStage(long long numSteps)
+{
+    this->numSteps = numSteps;
+    numDone = 0;
+    lastReported = 0;
+    if (progressCallback)
+    {
+        progressCallback(0.0);
+    }
+}
+
+/**
+ * @brief JobControl::addDone reports that some steps of the current stage are done
+ * @param numDone number of steps done since the last report
+ */
+void JobControl::addDone(long long numDone)
+{
+    long long done = this->numDone.fetch_add(numDone, std::memory_order_relaxed) + numDone;
+    if (!progressCallback)
+    {
+        return;
+    }
+
+    // Only the thread that moves the progress to a new percent reports it
+    long long steps = numSteps.load(std::memory_order_relaxed);
+    int percent = (steps > 0)? int(100 * done / steps) : 100;
+    int reported = lastReported.load(std::memory_order_relaxed);
+    while (percent > reported)
+    {
+        if (lastReported.compare_exchange_weak(reported, percent))
+        {
+            progressCallback(percent / 100.0);
+            return;
+        }
+    }
+}
+
+/**
+ * @brief JobControl::getProgress
+ * @return the fraction of the steps of the current stage that are done, from 0 to 1
+ */
+double JobControl::getProgress() const
+{
+    long long steps = numSteps.load(std::memory_order_relaxed);
+    if (steps <= 0)
+    {
+        return 0.0;
+    }
+    double progress = double(numDone.load(std::memory_order_relaxed)) / steps;
+    return (progress < 1.0)? progress : 1.0;
+}
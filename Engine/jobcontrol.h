@@ -0,0 +1,69 @@
+#ifndef JOBCONTROL_H
+#define JOBCONTROL_H
+
+#include <atomic>
+#include <functional>
+
+/**
+ * @brief The JobControl class is shared between a long computation and the
+ *  code that started it. The computation reports how many of its steps are
+ *  done and checks regularly whether it has been asked to stop; the other
+ *  side reads the progress and can cancel it. Every method can be called
+ *  from any thread.
+ */
+class JobControl
+{
+private:
+    std::atomic<bool> cancelled;
+    //Keeps the flag read by every thread apart from the counter they write
+    char padding[64];
+    std::atomic<long long> numDone;
+    std::atomic<long long> numSteps;
+    std::atomic<int> lastReported;
+    std::function<void(double)> progressCallback;
+
+public:
+    /**
+     * @brief JobControl creates a control of a job that has not started
+     */
+    JobControl();
+
+    /**
+     * @brief setProgressCallback defines a function called every time the
+     *  progress grows by at least 1%. It is called from the threads of the
+     *  computation, so it must be thread safe and return quickly.
+     * @param progressCallback function that receives the progress, from 0 to 1
+     */
+    void setProgressCallback(const std::function<void(double)> & progressCallback);
+
+    /**
+     * @brief cancel asks the computation to stop as soon as possible
+     */
+    void cancel();
+
+    /**
+     * @brief isCancelled
+     * @return true if cancel has been called
+     */
+    bool isCancelled() const;
+
+    /**
+     * @brief startStage resets the progress for a new stage of the computation
+     * @param numSteps number of steps of the stage
+     */
+    void startStage(long long numSteps);
+
+    /**
+     * @brief addDone reports that some steps of the current stage are done
+     * @param numDone number of steps done since the last report
+     */
+    void addDone(long long numDone);
+
+    /**
+     * @brief getProgress
+     * @return the fraction of the steps of the current stage that are done, from 0 to 1
+     */
+    double getProgress() const;
+};
+
+#endif // JOBCONTROL_H
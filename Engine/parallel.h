@@ -0,0 +1,102 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief defaultThreadCount returns the number of threads that should be used
+ *  when the user does not define one explicitly.
+ * @return the number of hardware threads, or 1 if it can not be detected
+ */
+inline int defaultThreadCount()
+{
+    int numThreads = int(std::thread::hardware_concurrency());
+    return (numThreads > 0)? numThreads : 1;
+}
+
+/**
+ * @brief parallelFor runs body(index, threadId) for every index in [begin, end)
+ *  using numThreads threads. The range is split in chunks of chunkSize indexes
+ *  which are handed to the threads on demand through an atomic counter, so a
+ *  thread that finishes early takes the next pending chunk instead of waiting.
+ *  The calling thread is used as the worker with threadId 0. If body throws,
+ *  no more chunks are handed out and the first exception is rethrown once
+ *  every thread has finished its current chunk.
+ * @param begin first index of the range
+ * @param end index after the last index of the range
+ * @param numThreads number of threads to use (values lower than 1 run serially)
+ * @param chunkSize number of consecutive indexes handed to a thread at once
+ * @param body callable object with signature void(int index, int threadId)
+ */
+template <typename Function>
+void parallelFor(int begin, int end, int numThreads, int chunkSize, const Function & body)
+{
+    if (end <= begin)
+    {
+        return;
+    }
+    chunkSize = std::max(chunkSize, 1);
+    int numChunks = (end - begin + chunkSize - 1) / chunkSize;
+    numThreads = std::max(1, std::min(numThreads, numChunks));
+
+    if (numThreads == 1)
+    {
+        for (int i = begin; i < end; i++)
+        {
+            body(i, 0);
+        }
+        return;
+    }
+
+    std::atomic<int> nextChunk(0);
+    std::exception_ptr error;
+    std::mutex errorMutex;
+    auto worker = [&](int threadId)
+    {
+        try
+        {
+            for (int chunk = nextChunk++; chunk < numChunks; chunk = nextChunk++)
+            {
+                int chunkBegin = begin + chunk * chunkSize;
+                int chunkEnd = std::min(end, chunkBegin + chunkSize);
+                for (int i = chunkBegin; i < chunkEnd; i++)
+                {
+                    body(i, threadId);
+                }
+            }
+        }
+        catch (...)
+        {
+            // An exception leaving a std::thread would terminate the program
+            std::lock_guard<std::mutex> lock(errorMutex);
+            if (!error)
+            {
+                error = std::current_exception();
+            }
+            nextChunk = numChunks;
+        }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(numThreads - 1);
+    for (int t = 1; t < numThreads; t++)
+    {
+        threads.push_back(std::thread(worker, t));
+    }
+    worker(0);
+    for (unsigned int t = 0; t < threads.size(); t++)
+    {
+        threads[t].join();
+    }
+    if (error)
+    {
+        std::rethrow_exception(error);
+    }
+}
+
+#endif // PARALLEL_H
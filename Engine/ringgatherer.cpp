@@ -0,0 +1,66 @@
+#include "Engine/ringgatherer.h"
+#include <algorithm>
+
+/**
+ * @brief RingGatherer Default constructor for class RingGatherer
+ */
+RingGatherer::RingGatherer()
+{
+    epoch = 0;
+}
+
+/**
+ * @brief gather collects the vertexes whose distance in edges to vertex is
+ *  lower or equal than depth, vertex included
+ * @param vertex is the index of the vertex
+ * @param depth is the maximum distance in edges to vertex
+ * @param adjacency is the precomputed adjacency of the mesh
+ * @return a view of the sorted indexes of the neighbourhood, valid until
+ *  the next call to gather
+ */
+Map<const VectorXi> RingGatherer::gather(int vertex, int depth, const Adjacency * adjacency)
+{
+    unsigned int numVertexes = adjacency->getNumVertexes();
+    if (visited.size() != numVertexes)
+    {
+        visited.assign(numVertexes, 0);
+        epoch = 0;
+    }
+
+    // When the counter wraps around, old marks could match the new epoch
+    epoch++;
+    if (epoch == 0)
+    {
+        std::fill(visited.begin(), visited.end(), 0);
+        epoch = 1;
+    }
+
+    neighbourhood.clear();
+    neighbourhood.push_back(vertex);
+    visited[vertex] = epoch;
+
+    // Vertexes of the current ring are in [ringBegin, ringEnd)
+    int ringBegin = 0;
+    int ringEnd = 1;
+    for (int ring = 1; ring <= depth && ringBegin < ringEnd; ring++)
+    {
+        for (int i = ringBegin; i < ringEnd; i++)
+        {
+            const int * neighbours = adjacency->getNeighbours(neighbourhood[i]);
+            int numNeighbours = adjacency->getNumNeighbours(neighbourhood[i]);
+            for (int j = 0; j < numNeighbours; j++)
+            {
+                if (visited[neighbours[j]] != epoch)
+                {
+                    visited[neighbours[j]] = epoch;
+                    neighbourhood.push_back(neighbours[j]);
+                }
+            }
+        }
+        ringBegin = ringEnd;
+        ringEnd = neighbourhood.size();
+    }
+
+    std::sort(neighbourhood.begin(), neighbourhood.end());
+    return Map<const VectorXi>(neighbourhood.data(), neighbourhood.size());
+}
@@ -0,0 +1,55 @@
+#ifndef RINGGATHERER_H
+#define RINGGATHERER_H
+
+#include "BasicStructures/adjacency.h"
+#include <Eigen/Core>
+#include <vector>
+
+using namespace Eigen;
+using std::vector;
+
+/**
+ * @brief The RingGatherer class collects the k-ring neighbourhood of a vertex
+ *  with a breadth-first search over the adjacency of the mesh. Its buffers are
+ *  reused from one vertex to the next, and vertexes are marked as visited with
+ *  the number of the current search (epoch), so nothing has to be cleared
+ *  between two searches. An instance must be used by one thread at a time.
+ */
+class RingGatherer
+{
+private:
+    /**
+     * @brief visited Epoch of the last search that reached each vertex
+     */
+    vector<unsigned int> visited;
+
+    /**
+     * @brief epoch Number of the current search
+     */
+    unsigned int epoch;
+
+    /**
+     * @brief neighbourhood Vertexes reached by the current search. It is also
+     *  used as the queue of the breadth-first search.
+     */
+    vector<int> neighbourhood;
+
+public:
+    /**
+     * @brief RingGatherer Default constructor for class RingGatherer
+     */
+    RingGatherer();
+
+    /**
+     * @brief gather collects the vertexes whose distance in edges to vertex is
+     *  lower or equal than depth, vertex included
+     * @param vertex is the index of the vertex
+     * @param depth is the maximum distance in edges to vertex
+     * @param adjacency is the precomputed adjacency of the mesh
+     * @return a view of the sorted indexes of the neighbourhood, valid until
+     *  the next call to gather
+     */
+    Map<const VectorXi> gather(int vertex, int depth, const Adjacency * adjacency);
+};
+
+#endif // RINGGATHERER_H
@@ -0,0 +1,73 @@
+#include "Engine/spatialgrid.h"
+#include <cmath>
+
+/**
+ * @brief SpatialGrid constructs an empty grid
+ * @param radius is the search radius, used as the side of the cells.
+ *  It must be greater than 0.
+ */
+SpatialGrid::SpatialGrid(double radius)
+{
+    cellSize = radius;
+}
+
+/**
+ * @brief getCell computes the cell that contains a point
+ * @param point coordinates of the point
+ * @return the key of the cell
+ */
+SpatialGrid::CellKey SpatialGrid::getCell(const Vector3d & point)
+{
+    CellKey key;
+    key.x = (long long)std::floor(point(0) / cellSize);
+    key.y = (long long)std::floor(point(1) / cellSize);
+    key.z = (long long)std::floor(point(2) / cellSize);
+    return key;
+}
+
+/**
+ * @brief insert adds a point to the grid
+ * @param point coordinates of the point
+ */
+void SpatialGrid::insert(const Vector3d & point)
+{
+    cells[getCell(point)].push_back(points.size());
+    points.push_back(point);
+}
+
+/**
+ * @brief hasPointCloserThanRadius checks if any inserted point lies at a
+ *  distance strictly lower than the radius of the grid
+ * @param point coordinates of the query point
+ * @return true if there is a point closer than the radius
+ */
+bool SpatialGrid::hasPointCloserThanRadius(const Vector3d & point)
+{
+    CellKey centre = getCell(point);
+    CellKey key;
+    for (long long dx = -1; dx <= 1; dx++)
+    {
+        for (long long dy = -1; dy <= 1; dy++)
+        {
+            for (long long dz = -1; dz <= 1; dz++)
+            {
+                key.x = centre.x + dx;
+                key.y = centre.y + dy;
+                key.z = centre.z + dz;
+                unordered_map<CellKey, vector<int>, CellKeyHash>::const_iterator cell = cells.find(key);
+                if (cell == cells.end())
+                {
+                    continue;
+                }
+                for (unsigned int i = 0; i < cell->second.size(); i++)
+                {
+                    if ((points[cell->second[i]] - point).norm() < cellSize)
+                    {
+                        return true;
+                    }
+                }
+            }
+        }
+    }
+    return false;
+}
@@ -0,0 +1,94 @@
+#ifndef SPATIALGRID_H
+#define SPATIALGRID_H
+
+#include <Eigen/Core>
+#include <unordered_map>
+#include <vector>
+
+using namespace Eigen;
+using std::unordered_map;
+using std::vector;
+
+/**
+ * @brief The SpatialGrid class is a uniform hash grid of 3D points. Points are
+ *  stored in cubic cells whose side is the search radius, so a radius query
+ *  only has to visit the cell of the query point and its 26 neighbours.
+ */
+class SpatialGrid
+{
+private:
+    /**
+     * @brief The CellKey struct identifies a cell by its integer coordinates
+     */
+    struct CellKey
+    {
+        long long x;
+        long long y;
+        long long z;
+
+        bool operator==(const CellKey & other) const
+        {
+            return x == other.x && y == other.y && z == other.z;
+        }
+    };
+
+    /**
+     * @brief The CellKeyHash struct hashes the coordinates of a cell
+     */
+    struct CellKeyHash
+    {
+        size_t operator()(const CellKey & key) const
+        {
+            unsigned long long hash = (unsigned long long)key.x * 73856093ULL;
+            hash ^= (unsigned long long)key.y * 19349663ULL;
+            hash ^= (unsigned long long)key.z * 83492791ULL;
+            return size_t(hash ^ (hash >> 29));
+        }
+    };
+
+    /**
+     * @brief cellSize Side of the cells, equal to the search radius
+     */
+    double cellSize;
+
+    /**
+     * @brief points Coordinates of the inserted points
+     */
+    vector<Vector3d> points;
+
+    /**
+     * @brief cells Positions in points of the points inside each cell
+     */
+    unordered_map<CellKey, vector<int>, CellKeyHash> cells;
+
+    /**
+     * @brief getCell computes the cell that contains a point
+     * @param point coordinates of the point
+     * @return the key of the cell
+     */
+    CellKey getCell(const Vector3d & point);
+
+public:
+    /**
+     * @brief SpatialGrid constructs an empty grid
+     * @param radius is the search radius, used as the side of the cells.
+     *  It must be greater than 0.
+     */
+    SpatialGrid(double radius);
+
+    /**
+     * @brief insert adds a point to the grid
+     * @param point coordinates of the point
+     */
+    void insert(const Vector3d & point);
+
+    /**
+     * @brief hasPointCloserThanRadius checks if any inserted point lies at a
+     *  distance strictly lower than the radius of the grid
+     * @param point coordinates of the query point
+     * @return true if there is a point closer than the radius
+     */
+    bool hasPointCloserThanRadius(const Vector3d & point);
+};
+
+#endif // SPATIALGRID_H
@@ -0,0 +1,175 @@
+#include "Engine/stageprofile.h"
+#include <cstring>
+
+/**
+ * @brief stageNames Names of the stages in the written files, in the order of ProfileStage
+ */
+static const char * const stageNames[NUM_PROFILE_STAGES] =
+{
+    "adjacency", "coefficients", "rings", "gather", "centering", "pca",
+    "fit", "ematrix", "response", "nms", "sort", "selection"
+};
+
+/**
+ * @brief StageProfile::StageProfile creates an empty profile for one thread
+ */
+StageProfile::StageProfile()
+{
+    reset();
+}
+
+/**
+ * @brief StageProfile::reset clears the counters and the timeline, which
+ *  starts again now
+ */
+void StageProfile::reset()
+{
+    threads.clear();
+    prepare(1);
+    origin = Clock::now();
+}
+
+/**
+ * @brief StageProfile::prepare makes room for the counters of some threads.
+ *  It must be called before they start, from a single thread.
+ * @param numThreads number of threads, with ids from 0 to numThreads - 1
+ */
+void StageProfile::prepare(int numThreads)
+{
+    while(int(threads.size()) < numThreads)
+    {
+        threads.push_back(ThreadTimes());
+        ThreadTimes & times = threads.back();
+        memset(times.nanoseconds, 0, sizeof(times.nanoseconds));
+        memset(times.calls, 0, sizeof(times.calls));
+    }
+}
+
+/**
+ * @brief StageProfile::addSpan accumulates a call of a stage, as add does,
+ *  and keeps it in the timeline
+ * @param stage the stage
+ * @param threadId the thread that ran it, as given by parallelFor
+ * @param start the time when the call started
+ * @param end the time when the call ended
+ */
+void StageProfile::addSpan(ProfileStage stage, int threadId, Clock::time_point start, Clock::time_point end)
+{
+    add(stage, threadId, start, end);
+    TraceEvent event;
+    event.stage = stage;
+    event.start = std::chrono::duration_cast<std::chrono::nanoseconds>(start - origin).count();
+    event.duration = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+    threads[threadId].events.push_back(event);
+}
+
+/**
+ * @brief StageProfile::getNumThreads
+ * @return the number of threads with counters
+ */
+int StageProfile::getNumThreads() const
+{
+    return threads.size();
+}
+
+/**
+ * @brief StageProfile::getCalls
+ * @param stage the stage
+ * @param threadId the thread, or -1 for all of them
+ * @return the number of calls of the stage
+ */
+long long StageProfile::getCalls(ProfileStage stage, int threadId) const
+{
+    if(threadId >= 0)
+    {
+        return threads[threadId].calls[stage];
+    }
+    long long calls(0);
+    for(const ThreadTimes & times : threads)
+    {
+        calls += times.calls[stage];
+    }
+    return calls;
+}
+
+/**
+ * @brief StageProfile::getSeconds
+ * @param stage the stage
+ * @param threadId the thread, or -1 for all of them
+ * @return the wall time spent in the stage, added over the threads
+ */
+double StageProfile::getSeconds(ProfileStage stage, int threadId) const
+{
+    long long nanoseconds(0);
+    if(threadId >= 0)
+    {
+        nanoseconds = threads[threadId].nanoseconds[stage];
+    }
+    else
+    {
+        for(const ThreadTimes & times : threads)
+        {
+            nanoseconds += times.nanoseconds[stage];
+        }
+    }
+    return nanoseconds * 1e-9;
+}
+
+/**
+ * @brief StageProfile::getStageName
+ * @param stage the stage
+ * @return the name of the stage in the written files, e.g. "rings"
+ */
+const char * StageProfile::getStageName(ProfileStage stage)
+{
+    return stageNames[stage];
+}
+
+/**
+ * @brief StageProfile::writeJson writes the counters of every stage, in total
+ *  and per thread, as a JSON object
+ * @param out the stream
+ */
+void StageProfile::writeJson(std::ostream & out) const
+{
+    out << "{\n  \"numThreads\": " << threads.size() << ",\n  \"stages\": [";
+    for(int iStage = 0; iStage < NUM_PROFILE_STAGES; iStage++)
+    {
+        ProfileStage stage = ProfileStage(iStage);
+        out << ((iStage > 0)? ",\n" : "\n")
+            << "    {\"name\": \"" << stageNames[stage] << "\", \"calls\": " << getCalls(stage)
+            << ", \"seconds\": " << getSeconds(stage) << ", \"threads\": [";
+        for(unsigned int iThread = 0; iThread < threads.size(); iThread++)
+        {
+            out << ((iThread > 0)? ", " : "")
+                << "{\"calls\": " << getCalls(stage, iThread)
+                << ", \"seconds\": " << getSeconds(stage, iThread) << "}";
+        }
+        out << "]}";
+    }
+    out << "\n  ]\n}\n";
+}
+
+/**
+ * @brief StageProfile::writeChromeTrace writes the timeline as a JSON object
+ *  in the trace event format, with one track per thread
+ * @param out the stream
+ */
+void StageProfile::writeChromeTrace(std::ostream & out) const
+{
+    //Complete events ("ph": "X"), times in microseconds
+    out << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [";
+    bool first = true;
+    for(unsigned int iThread = 0; iThread < threads.size(); iThread++)
+    {
+        for(const TraceEvent & event : threads[iThread].events)
+        {
+            out << (first? "\n" : ",\n")
+                << "  {\"name\": \"" << stageNames[event.stage] << "\", \"cat\": \"engine\", \"ph\": \"X\""
+                << ", \"pid\": 1, \"tid\": " << iThread
+                << ", \"ts\": " << event.start / 1000.0 << ", \"dur\": " << event.duration / 1000.0 << "}";
+            first = false;
+        }
+    }
+    out << "\n]}\n";
+}
@@ -0,0 +1,197 @@
+#ifndef STAGEPROFILE_H
+#define STAGEPROFILE_H
+
+#include <chrono>
+#include <cstddef>
+#include <ostream>
+#include <vector>
+
+using std::vector;
+
+/**
+ * @brief The ProfileStage enum lists the stages of the computation of the
+ *  interest points that are timed. COEFFICIENTS is the whole per-vertex loop
+ *  of every thread, which contains the stages from RINGS to EMATRIX.
+ */
+enum ProfileStage
+{
+    STAGE_ADJACENCY,
+    STAGE_COEFFICIENTS,
+    STAGE_RINGS,
+    STAGE_GATHER,
+    STAGE_CENTERING,
+    STAGE_PCA,
+    STAGE_FIT,
+    STAGE_EMATRIX,
+    STAGE_RESPONSE,
+    STAGE_NMS,
+    STAGE_SORT,
+    STAGE_SELECTION,
+    NUM_PROFILE_STAGES
+};
+
+/**
+ * @brief The StageProfile class accumulates the wall time and the number of
+ *  calls of every stage of the Engine, for every thread. Every thread only
+ *  writes its own counters, so the per-vertex stages are timed without any
+ *  synchronization. Stages that run once per query, and the per-vertex loop
+ *  of every thread, are also kept as events of a timeline, which can be
+ *  written in the trace event format of Chrome (chrome://tracing).
+ */
+class StageProfile
+{
+public:
+    typedef std::chrono::steady_clock Clock;
+
+private:
+    /**
+     * @brief The TraceEvent struct is a span of the timeline, in nanoseconds
+     *  since the profile was reset
+     */
+    struct TraceEvent
+    {
+        ProfileStage stage;
+        long long start;
+        long long duration;
+    };
+
+    /**
+     * @brief The ThreadTimes struct holds the counters of one thread, padded
+     *  so that two threads do not write to the same cache line
+     */
+    struct ThreadTimes
+    {
+        long long nanoseconds[NUM_PROFILE_STAGES];
+        long long calls[NUM_PROFILE_STAGES];
+        vector<TraceEvent> events;
+        char padding[64];
+    };
+
+    vector<ThreadTimes> threads;
+    Clock::time_point origin;
+
+public:
+    /**
+     * @brief StageProfile creates an empty profile for one thread
+     */
+    StageProfile();
+
+    /**
+     * @brief reset clears the counters and the timeline, which starts again now
+     */
+    void reset();
+
+    /**
+     * @brief prepare makes room for the counters of some threads. It must be
+     *  called before they start, from a single thread.
+     * @param numThreads number of threads, with ids from 0 to numThreads - 1
+     */
+    void prepare(int numThreads);
+
+    /**
+     * @brief add accumulates a call of a stage
+     * @param stage the stage
+     * @param threadId the thread that ran it, as given by parallelFor
+     * @param start the time when the call started
+     * @param end the time when the call ended
+     */
+    void add(ProfileStage stage, int threadId, Clock::time_point start, Clock::time_point end)
+    {
+        ThreadTimes & times = threads[threadId];
+        times.nanoseconds[stage] += std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+        times.calls[stage]++;
+    }
+
+    /**
+     * @brief addSpan accumulates a call of a stage, as add does, and keeps it
+     *  in the timeline
+     * @param stage the stage
+     * @param threadId the thread that ran it, as given by parallelFor
+     * @param start the time when the call started
+     * @param end the time when the call ended
+     */
+    void addSpan(ProfileStage stage, int threadId, Clock::time_point start, Clock::time_point end);
+
+    /**
+     * @brief getNumThreads
+     * @return the number of threads with counters
+     */
+    int getNumThreads() const;
+
+    /**
+     * @brief getCalls
+     * @param stage the stage
+     * @param threadId the thread, or -1 for all of them
+     * @return the number of calls of the stage
+     */
+    long long getCalls(ProfileStage stage, int threadId = -1) const;
+
+    /**
+     * @brief getSeconds
+     * @param stage the stage
+     * @param threadId the thread, or -1 for all of them
+     * @return the wall time spent in the stage, added over the threads
+     */
+    double getSeconds(ProfileStage stage, int threadId = -1) const;
+
+    /**
+     * @brief getStageName
+     * @param stage the stage
+     * @return the name of the stage in the written files, e.g. "rings"
+     */
+    static const char * getStageName(ProfileStage stage);
+
+    /**
+     * @brief writeJson writes the counters of every stage, in total and per
+     *  thread, as a JSON object
+     * @param out the stream
+     */
+    void writeJson(std::ostream & out) const;
+
+    /**
+     * @brief writeChromeTrace writes the timeline as a JSON object in the
+     *  trace event format, with one track per thread
+     * @param out the stream
+     */
+    void writeChromeTrace(std::ostream & out) const;
+};
+
+/**
+ * @brief The ProfileTimer class times a scope as a span of a stage. It does
+ *  nothing when the profile is NULL.
+ */
+class ProfileTimer
+{
+private:
+    StageProfile * profile;
+    ProfileStage stage;
+    StageProfile::Clock::time_point start;
+
+public:
+    /**
+     * @brief ProfileTimer starts timing a stage on the thread 0
+     * @param profile the profile, or NULL to time nothing
+     * @param stage the stage
+     */
+    ProfileTimer(StageProfile * profile, ProfileStage stage)
+        : profile(profile), stage(stage)
+    {
+        if(profile != NULL)
+        {
+            start = StageProfile::Clock::now();
+        }
+    }
+
+    /**
+     * @brief ~ProfileTimer adds the time since the construction to the profile
+     */
+    ~ProfileTimer()
+    {
+        if(profile != NULL)
+        {
+            profile->addSpan(stage, 0, start, StageProfile::Clock::now());
+        }
+    }
+};
+
+#endif // STAGEPROFILE_H
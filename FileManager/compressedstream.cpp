@@ -0,0 +1,323 @@
+#include "compressedstream.h"
+#include <QFile>
+#include <algorithm>
+#include <cstring>
+#include <zlib.h>
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+/**
+ * @brief CompressedStream::CompressedStream starts decompressing a file
+ * @param fileName path of the compressed file
+ * @param blockSize approximate number of bytes of every block
+ * @param maxQueuedBlocks maximum number of blocks waiting to be parsed
+ */
+CompressedStream::CompressedStream(const QString & fileName, size_t blockSize, size_t maxQueuedBlocks)
+{
+    this->fileName = fileName;
+    this->blockSize = std::max(blockSize, size_t(1024));
+    this->maxQueuedBlocks = std::max(maxQueuedBlocks, size_t(1));
+    finished = false;
+    stopped = false;
+    failed = false;
+    inputPosition = 0;
+    currentPosition = 0;
+    opened = isCompressed(fileName) && QFile::exists(fileName);
+    if(opened)
+    {
+        decompressor = std::thread(&CompressedStream::decompress, this);
+    }
+}
+
+/**
+ * @brief CompressedStream::~CompressedStream stops the decompression and waits
+ *  for its thread
+ */
+CompressedStream::~CompressedStream()
+{
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        stopped = true;
+    }
+    blockTaken.notify_all();
+    if(decompressor.joinable())
+    {
+        decompressor.join();
+    }
+}
+
+/**
+ * @brief CompressedStream::isOpen
+ * @return true if the file could be opened
+ */
+bool CompressedStream::isOpen()
+{
+    return opened;
+}
+
+/**
+ * @brief CompressedStream::hasError
+ * @return true if the file could not be decompressed completely
+ */
+bool CompressedStream::hasError()
+{
+    std::lock_guard<std::mutex> lock(queueMutex);
+    return failed;
+}
+
+/**
+ * @brief CompressedStream::getPosition
+ * @return the number of bytes of the compressed file that have been
+ *  decompressed into the blocks handed out so far
+ */
+qint64 CompressedStream::getPosition()
+{
+    std::lock_guard<std::mutex> lock(queueMutex);
+    return currentPosition;
+}
+
+/**
+ * @brief CompressedStream::isCompressed checks if a file is compressed in a
+ *  supported format, by its extension
+ * @param fileName path of the file
+ * @return true for .gz files, and .zst files when built with HAVE_ZSTD
+ */
+bool CompressedStream::isCompressed(const QString & fileName)
+{
+#ifdef HAVE_ZSTD
+    if(fileName.endsWith(".zst"))
+    {
+        return true;
+    }
+#endif
+    return fileName.endsWith(".gz");
+}
+
+/**
+ * @brief CompressedStream::getUncompressedName removes the compression
+ *  extension of a file name
+ * @param fileName path of the file, e.g. mesh.off.gz
+ * @return the name without the compression extension, e.g. mesh.off
+ */
+QString CompressedStream::getUncompressedName(const QString & fileName)
+{
+    if(fileName.endsWith(".gz"))
+    {
+        return fileName.left(fileName.length() - 3);
+    }
+    if(fileName.endsWith(".zst"))
+    {
+        return fileName.left(fileName.length() - 4);
+    }
+    return fileName;
+}
+
+/**
+ * @brief CompressedStream::nextBlock waits for the next block of decompressed
+ *  content. The block stays valid until the next call.
+ * @param begin receives a pointer to the first character of the block
+ * @param end receives a pointer past the last character of the block
+ * @return false when there are no more blocks
+ */
+bool CompressedStream::nextBlock(const char * & begin, const char * & end)
+{
+    std::unique_lock<std::mutex> lock(queueMutex);
+    blockQueued.wait(lock, [this](){ return !queue.empty() || finished; });
+    if(queue.empty())
+    {
+        return false;
+    }
+    currentBlock.swap(queue.front());
+    queue.pop_front();
+    currentPosition = queuedPositions.front();
+    queuedPositions.pop_front();
+    lock.unlock();
+    blockTaken.notify_one();
+
+    begin = currentBlock.data();
+    end = begin + currentBlock.size();
+    return true;
+}
+
+/**
+ * @brief CompressedStream::pushBlock adds a block to the queue, waiting while
+ *  it is full
+ * @param block the block, which is moved into the queue
+ * @return false if the stream was destroyed while waiting
+ */
+bool CompressedStream::pushBlock(vector<char> & block)
+{
+    std::unique_lock<std::mutex> lock(queueMutex);
+    blockTaken.wait(lock, [this](){ return queue.size() < maxQueuedBlocks || stopped; });
+    if(stopped)
+    {
+        return false;
+    }
+    queue.push_back(vector<char>());
+    queue.back().swap(block);
+    queuedPositions.push_back(inputPosition);
+    lock.unlock();
+    blockQueued.notify_one();
+    return true;
+}
+
+/**
+ * @brief CompressedStream::decompress runs on the decompression thread,
+ *  filling the queue until the end of the file or until the stream is destroyed
+ */
+void CompressedStream::decompress()
+{
+    // Decompressed bytes are gathered in a block; when it is full, the part
+    // after its last line break is moved to the next one, so that every block
+    // can be parsed on its own
+    vector<char> block;
+    block.reserve(blockSize + blockSize / 4);
+    bool running = true;
+    auto pushData = [&](const char * data, size_t size)
+    {
+        block.insert(block.end(), data, data + size);
+        if(block.size() < blockSize)
+        {
+            return running;
+        }
+        vector<char>::iterator lastLineBreak = std::find(block.rbegin(), block.rend(), '\n').base();
+        if(lastLineBreak == block.begin())
+        {
+            // A line longer than a block, keep gathering
+            return running;
+        }
+        vector<char> rest(lastLineBreak, block.end());
+        block.erase(lastLineBreak, block.end());
+        running = pushBlock(block);
+        block.swap(rest);
+        block.reserve(blockSize + blockSize / 4);
+        return running;
+    };
+
+    bool decompressed = true;
+#ifdef HAVE_ZSTD
+    if(fileName.endsWith(".zst"))
+    {
+        decompressed = decompressZstd(pushData);
+    }
+    else
+#endif
+    {
+        decompressed = decompressGzip(pushData);
+    }
+    if(running && decompressed && !block.empty())
+    {
+        running = pushBlock(block);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        failed = !decompressed;
+        finished = true;
+    }
+    blockQueued.notify_all();
+}
+
+/**
+ * @brief CompressedStream::decompressGzip reads a gzip file with zlib
+ * @param pushData callable object that receives the decompressed bytes
+ * @return false if the file could not be decompressed
+ */
+template <typename PushFunction>
+bool CompressedStream::decompressGzip(PushFunction & pushData)
+{
+    gzFile file = gzopen(QFile::encodeName(fileName).constData(), "rb");
+    if(file == NULL)
+    {
+        return false;
+    }
+    gzbuffer(file, 1 << 18);
+
+    vector<char> buffer(1 << 18);
+    bool decompressed = true;
+    while(true)
+    {
+        int numRead = gzread(file, buffer.data(), buffer.size());
+        if(numRead < 0)
+        {
+            decompressed = false;
+            break;
+        }
+        inputPosition = gzoffset(file);
+        if(numRead == 0 || !pushData(buffer.data(), numRead))
+        {
+            break;
+        }
+    }
+    gzclose(file);
+    return decompressed;
+}
+
+#ifdef HAVE_ZSTD
+/**
+ * @brief CompressedStream::decompressZstd reads a zstd file with libzstd
+ * @param pushData callable object that receives the decompressed bytes
+ * @return false if the file could not be decompressed
+ */
+template <typename PushFunction>
+bool CompressedStream::decompressZstd(PushFunction & pushData)
+{
+    QFile file(fileName);
+    if(!file.open(QIODevice::ReadOnly))
+    {
+        return false;
+    }
+
+    ZSTD_DStream * stream = ZSTD_createDStream();
+    ZSTD_initDStream(stream);
+    vector<char> input(ZSTD_DStreamInSize());
+    vector<char> output(ZSTD_DStreamOutSize());
+    bool decompressed = true;
+    bool running = true;
+    size_t lastResult = 0;
+    while(running)
+    {
+        qint64 numRead = file.read(input.data(), input.size());
+        if(numRead < 0)
+        {
+            decompressed = false;
+            break;
+        }
+        inputPosition = file.pos();
+        ZSTD_inBuffer inBuffer = {input.data(), size_t(numRead), 0};
+
+        // A call that fills the output buffer may leave decompressed data in
+        // the stream, so it is called again until the input is consumed and
+        // the output buffer is not full. After the last read this flushes
+        // what is left with no input.
+        bool outputFull = (numRead == 0 && lastResult != 0);
+        while((inBuffer.pos < inBuffer.size || outputFull) && running)
+        {
+            ZSTD_outBuffer outBuffer = {output.data(), output.size(), 0};
+            lastResult = ZSTD_decompressStream(stream, &outBuffer, &inBuffer);
+            if(ZSTD_isError(lastResult))
+            {
+                decompressed = false;
+                running = false;
+                break;
+            }
+            outputFull = (outBuffer.pos == outBuffer.size);
+            running = pushData(output.data(), outBuffer.pos);
+            if(numRead == 0 && outBuffer.pos == 0)
+            {
+                break;
+            }
+        }
+        if(numRead == 0)
+        {
+            // The last frame must be complete
+            decompressed = decompressed && (lastResult == 0);
+            break;
+        }
+    }
+    ZSTD_freeDStream(stream);
+    file.close();
+    return decompressed;
+}
+#endif
@@ -0,0 +1,131 @@
+#ifndef COMPRESSEDSTREAM_H
+#define COMPRESSEDSTREAM_H
+
+#include <QString>
+#include <QtGlobal>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using std::vector;
+
+/**
+ * @brief The CompressedStream class decompresses a gzip file (or a zstd file
+ *  when the program is built with HAVE_ZSTD) on a separate thread, so that
+ *  the content can be parsed while the rest of the file is decompressed.
+ *  The content is handed out in blocks that end at a line break, and at most
+ *  a fixed number of blocks are kept in memory waiting to be parsed.
+ */
+class CompressedStream
+{
+private:
+    QString fileName;
+    size_t blockSize;
+    size_t maxQueuedBlocks;
+
+    std::thread decompressor;
+    std::mutex queueMutex;
+    std::condition_variable blockQueued;
+    std::condition_variable blockTaken;
+    std::deque<vector<char> > queue;
+    std::deque<qint64> queuedPositions;
+    vector<char> currentBlock;
+    qint64 inputPosition;
+    qint64 currentPosition;
+    bool finished;
+    bool stopped;
+    bool failed;
+    bool opened;
+
+    /**
+     * @brief decompress runs on the decompression thread, filling the queue
+     *  until the end of the file or until the stream is destroyed
+     */
+    void decompress();
+
+    /**
+     * @brief decompressGzip reads a gzip file with zlib
+     * @param pushData callable object that receives the decompressed bytes
+     * @return false if the file could not be decompressed
+     */
+    template <typename PushFunction>
+    bool decompressGzip(PushFunction & pushData);
+
+#ifdef HAVE_ZSTD
+    /**
+     * @brief decompressZstd reads a zstd file with libzstd
+     * @param pushData callable object that receives the decompressed bytes
+     * @return false if the file could not be decompressed
+     */
+    template <typename PushFunction>
+    bool decompressZstd(PushFunction & pushData);
+#endif
+
+    /**
+     * @brief pushBlock adds a block to the queue, waiting while it is full
+     * @param block the block, which is moved into the queue
+     * @return false if the stream was destroyed while waiting
+     */
+    bool pushBlock(vector<char> & block);
+
+public:
+    /**
+     * @brief CompressedStream starts decompressing a file
+     * @param fileName path of the compressed file
+     * @param blockSize approximate number of bytes of every block
+     * @param maxQueuedBlocks maximum number of blocks waiting to be parsed
+     */
+    CompressedStream(const QString & fileName, size_t blockSize = 4 << 20, size_t maxQueuedBlocks = 4);
+
+    /**
+     * @brief ~CompressedStream stops the decompression and waits for its thread
+     */
+    ~CompressedStream();
+
+    /**
+     * @brief isOpen
+     * @return true if the file could be opened
+     */
+    bool isOpen();
+
+    /**
+     * @brief nextBlock waits for the next block of decompressed content. The
+     *  block stays valid until the next call.
+     * @param begin receives a pointer to the first character of the block
+     * @param end receives a pointer past the last character of the block
+     * @return false when there are no more blocks
+     */
+    bool nextBlock(const char * & begin, const char * & end);
+
+    /**
+     * @brief hasError
+     * @return true if the file could not be decompressed completely
+     */
+    bool hasError();
+
+    /**
+     * @brief getPosition
+     * @return the number of bytes of the compressed file that have been
+     *  decompressed into the blocks handed out so far
+     */
+    qint64 getPosition();
+
+    /**
+     * @brief isCompressed checks if a file is compressed in a supported format,
+     *  by its extension
+     * @param fileName path of the file
+     * @return true for .gz files, and .zst files when built with HAVE_ZSTD
+     */
+    static bool isCompressed(const QString & fileName);
+
+    /**
+     * @brief getUncompressedName removes the compression extension of a file name
+     * @param fileName path of the file, e.g. mesh.off.gz
+     * @return the name without the compression extension, e.g. mesh.off
+     */
+    static QString getUncompressedName(const QString & fileName);
+};
+
+#endif // COMPRESSEDSTREAM_H
@@ -1,14 +1,126 @@
 #include "filemanager.h"
+#include "../Engine/parallel.h"
+#include <QDateTime>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <cstdio>
+#include <cstring>
+
+/**
+ * @brief alignSection Rounds a position of a cache file up to the start of the next section
+ * @param position Position in bytes
+ * @return The first multiple of 8 that is not lower than position
+ */
+static inline qint64 alignSection(qint64 position)
+{
+    return (position + 7) & ~qint64(7);
+}
+
+/**
+ * @brief findLineEnd Finds the end of the line that contains a position
+ * @param position Pointer to a character of the line
+ * @param end Pointer past the last character of the text
+ * @return A pointer to the '\n' that ends the line, or end for the last line
+ */
+static inline const char * findLineEnd(const char * position, const char * end)
+{
+    const char * lineEnd = static_cast<const char *>(memchr(position, '\n', end - position));
+    return (lineEnd == NULL)? end : lineEnd;
+}
+
+/**
+ * @brief progressBlockSize Size of the blocks in which a plain text file is
+ *  parsed when the progress is reported, large enough for the parsing threads
+ */
+static const qint64 progressBlockSize = 16 << 20;
 
 /**
  * @brief FileManager Constructor for FileManager
  */
 FileManager::FileManager()
 {
+    numThreads = defaultThreadCount();
+    control = NULL;
+}
+
+/**
+ * @brief setNumThreads defines the number of threads used to parse the files.
+ *  The mesh read does not depend on it.
+ * @param numThreads number of threads, 0 or less uses all the hardware threads
+ */
+void FileManager::setNumThreads(int numThreads)
+{
+    this->numThreads = (numThreads > 0)? numThreads : defaultThreadCount();
+}
+
+/**
+ * @brief getNumThreads
+ * @return the number of threads used to parse the files
+ */
+int FileManager::getNumThreads()
+{
+    return numThreads;
+}
+
+/**
+ * @brief setJobControl defines the control that receives the progress of the
+ *  next files read, as a number of bytes, and that can cancel them. A read
+ *  that is cancelled returns NULL.
+ * @param control the control of the job, NULL to read without one
+ */
+void FileManager::setJobControl(JobControl * control)
+{
+    this->control = control;
+}
+
+/**
+ * @brief isCancelled
+ * @return true if the job control has been cancelled, which makes the reads
+ *  return NULL
+ */
+bool FileManager::isCancelled()
+{
+    return control != NULL && control->isCancelled();
+}
+
+/**
+ * @brief startProgress Starts a stage of the job control, if any, with the
+ *  total size of the files that are going to be read
+ * @param fileNames Names of the files
+ */
+void FileManager::startProgress(const QStringList & fileNames)
+{
+    if(control == NULL)
+    {
+        return;
+    }
+    qint64 totalSize(0);
+    for(const QString & fileName : fileNames)
+    {
+        totalSize += QFileInfo(fileName).size();
+    }
+    control->startStage(totalSize);
+}
+
+/**
+ * @brief addProgress Reports to the job control, if any, that some bytes of
+ *  the files have been read
+ * @param numBytes Number of bytes read since the last report
+ * @return false if the job has been cancelled
+ */
+bool FileManager::addProgress(qint64 numBytes)
+{
+    if(control == NULL)
+    {
+        return true;
+    }
+    control->addDone(numBytes);
+    return !control->isCancelled();
 }
 
 /**
- * @brief readOFF Read an OFF file
+ * @brief readOFF Read an OFF file. Files compressed with gzip (.off.gz) are
+ *  decompressed on a second thread while they are parsed.
  * @param offFile Pointer to QFile for the OFF file selected from the GUI
  * @return A pointer to an object of the Mesh class containing read faces and vertexes
  */
@@ -16,102 +128,114 @@ Mesh * FileManager::readOFF(QFile * offFile)
 {
     //Get string names of the files
     QString offFileName = offFile->fileName();
-    string offFileNameString = offFileName.toStdString();
-    string line;
-    string fileFormat = offFileNameString.substr(offFileNameString.length() - 3, 3);
-
-    int numPoints(0);
-    int numFaces(0);
-    int numElementsPerFace(0);
-
-    if(fileFormat == "off")
-    {
-        //First, get number of vertexes and number of faces
-        unsigned int delimiterPos_1(0), delimiterPos_2(0), delimiterPos_3(0);
-        ifstream myfile (offFileNameString);
-        if (myfile.is_open())
-        {
-          getline(myfile,line); //Get first line
-          if(line=="OFF") //If first line is OFF, then it is an off file
-          {
-              getline(myfile, line); //Second line contains    NumberOfPoints  NumberOfFaces  NumberOfEdges
-
-              //This part was modified from https://bytes.com/topic/c/answers/133131-reading-file-off-format:
-              delimiterPos_1 = line.find(" ", 0); //Find first blank space
-              numPoints = atoi(line.substr(0,delimiterPos_1).c_str()); //Convert first number to integer
-              delimiterPos_2 = line.find(" ", delimiterPos_1+1); //Find second blank space
-              numFaces = atoi(line.substr(delimiterPos_1+1,delimiterPos_2-(delimiterPos_1+1)).c_str());
-           }else
-           {
-              return NULL;
-           }
-
-          //Now read values of points and faces and put them in a mesh
-          Mesh * surface = new Mesh();
-
-          //Now read points
-          double x(0), y(0), z(0);
-          for(int iPoint = 0; iPoint < numPoints; iPoint++)
-          {
-              getline(myfile, line);
-              delimiterPos_1 = line.find(" ", 0);
-              x = atof(line.substr(0,delimiterPos_1).c_str());
-              delimiterPos_2 = line.find(" ", delimiterPos_1+1);
-              y = atof(line.substr(delimiterPos_1+1,delimiterPos_2 - (delimiterPos_1 + 1)).c_str());
-              z = atof(line.substr(delimiterPos_2+1).c_str());
-
-              Vertex  * pointVertex = new Vertex;
-              pointVertex->setCoordinates(double(x),double(y),double(z));
-              pointVertex->setIndex(iPoint);
-              surface->addNewVertex(pointVertex);
-
-          }
-
-          //Read faces of the surface
-          int f0(0), f1(0), f2(0);
-          for(int iFace=0; iFace < numFaces; iFace++)
-          {
-              getline(myfile, line);
-              delimiterPos_1 = line.find(" ", 0);
-              numElementsPerFace = atoi(line.substr(0,delimiterPos_1).c_str());
-              if(numElementsPerFace != 3) //If faces are not triangular
-              {
-                    return NULL;
-              }
-
-              delimiterPos_2 = line.find(" ", delimiterPos_1+1);
-              f0 = atoi(line.substr(delimiterPos_1+1, delimiterPos_2 - (delimiterPos_1 + 1)).c_str());
-              delimiterPos_3 = line.find(" ", delimiterPos_2+1);
-              f1 = atoi(line.substr(delimiterPos_2+1, delimiterPos_3 - (delimiterPos_2 + 1)).c_str());
-              f2 = atoi(line.substr(delimiterPos_3+1).c_str());
-
-              surface->getVertex(f0)->addNewFace(iFace);
-              surface->getVertex(f1)->addNewFace(iFace);
-              surface->getVertex(f2)->addNewFace(iFace);
-
-              Face  * faceVertex = new Face;
-              faceVertex->setPointsInFace(f0, f1, f2);
-              faceVertex->setFaceIndex(iFace);
-              surface->addNewFace(faceVertex);
-          }
-            myfile.close(); //Close file at the end
-
-            return surface;
-        }
-        else
+    if(!CompressedStream::getUncompressedName(offFileName).endsWith("off"))
+    {
+        return NULL;
+    }
+
+    //The header is at the beginning of the first block, points and faces
+    //can be in any of them
+    int numPoints(-1), numFaces(0), numLinesRead(0);
+    vector<double> coordinates;
+    vector<int> triangles;
+    vector<int> sourceFaces;
+    //Every point line has at least 5 characters ("0 0 0") and every face line
+    //at least 7 ("3 0 1 2"), so the size of a plain file bounds the counts of
+    //the header before the points are allocated
+    qint64 fileSize = CompressedStream::isCompressed(offFileName)? -1 : QFileInfo(offFileName).size();
+    startProgress(QStringList(offFileName));
+    bool fileRead = readBlocks(offFileName, [&](const char * begin, const char * end)
+    {
+        if(numPoints < 0)
         {
-            return NULL;
+            TextParser parser(begin, end);
+            if(!parseOFFHeader(parser, numPoints, numFaces))
+            {
+                return false;
+            }
+            if(fileSize >= 0 && 5 * (qint64)numPoints + 7 * (qint64)numFaces > fileSize)
+            {
+                return false;
+            }
+            coordinates.resize(3 * (size_t)numPoints);
+            begin = parser.getPosition();
         }
-    }
-    else
+        return parseOFFBlock(begin, end, numPoints, numFaces, numLinesRead,
+                             coordinates.data(), triangles, sourceFaces);
+    });
+    if(!fileRead || numPoints < 0 || numLinesRead < numPoints + numFaces)
     {
         return NULL;
     }
-    return 0;
+
+    return buildPolygonalMesh(coordinates, triangles, sourceFaces, numFaces);
+}
+
+/**
+ * @brief parseOFFHeader Parse the first line of an OFF file
+ * @param parser Parser at the beginning of the file, left at the first point
+ * @param numPoints Receives the number of points of the file
+ * @param numFaces Receives the number of faces of the file
+ * @return false if the content is not a valid OFF file
+ */
+bool FileManager::parseOFFHeader(TextParser & parser, int & numPoints, int & numFaces)
+{
+    //First word is OFF, then it is an off file
+    const char * word = NULL;
+    int wordLength(0);
+    if(!parser.readWord(word, wordLength) || wordLength != 3 || string(word, 3) != "OFF")
+    {
+        return false;
+    }
+
+    //Next numbers are NumberOfPoints  NumberOfFaces  NumberOfEdges, edges are ignored
+    if(!parser.readInt(numPoints) || !parser.readInt(numFaces) || numPoints < 0 || numFaces < 0)
+    {
+        return false;
+    }
+    parser.skipLine();
+    return true;
+}
+
+/**
+ * @brief parseOFFBlock Parse a block of whole lines of an OFF file after its
+ *  header. The file has one point per line followed by one face per line.
+ *  Faces with more than 3 corners are split in triangles.
+ * @param begin Pointer to the first character of the block
+ * @param end Pointer past the last character of the block
+ * @param numPoints Number of points of the file
+ * @param numFaces Number of faces of the file
+ * @param numLinesRead Number of data lines read in the previous blocks, updated
+ * @param coordinates Array of 3 * numPoints elements that receives the points
+ * @param triangles Array where the indexes of the triangles are appended
+ * @param sourceFaces Array where the face every triangle comes from is appended
+ * @return true if every point and face could be read
+ */
+bool FileManager::parseOFFBlock(const char * begin, const char * end, int numPoints, int numFaces,
+                                int & numLinesRead, double * coordinates,
+                                vector<int> & triangles, vector<int> & sourceFaces)
+{
+    vector<const char *> chunks = splitInChunks(begin, end, numThreads);
+    vector<int> firstLines = countDataLines(chunks, numThreads, numLinesRead);
+
+    //Points are read first, polygons need them to be triangulated. Points
+    //always come before faces, so previous blocks have no faces pending.
+    if(!parseChunks(chunks, firstLines, numPoints, 0, numThreads, coordinates, NULL))
+    {
+        return false;
+    }
+    if(!parsePolygonChunks(chunks, firstLines, numPoints, numFaces, numThreads,
+                           coordinates, triangles, sourceFaces))
+    {
+        return false;
+    }
+    numLinesRead = firstLines.back();
+    return true;
 }
 
 /**
- * @brief readTriVert Read Tri and Vert files
+ * @brief readTriVert Read Tri and Vert files. Files compressed with gzip
+ *  (.tri.gz, .vert.gz) are decompressed on a second thread while they are parsed.
  * @param triFile Poitner to QFile specifying the TRI file selected from the GUI
  * @param vertFile Pointer to QFile specifying the VERT file selected from the GUI
  * @return A pointer to an object of the Mesh class containing faces and vertexes
@@ -120,120 +244,1425 @@ Mesh * FileManager::readTriVert(QFile * triFile, QFile * vertFile)
 {
     //Get string names of the files
     QString triFileName = triFile->fileName();
-    string triFileNameString = triFileName.toStdString();
     QString vertFileName = vertFile->fileName();
-    string vertFileNameString = vertFileName.toStdString();
+    if(!CompressedStream::getUncompressedName(vertFileName).endsWith("vert")
+            || !CompressedStream::getUncompressedName(triFileName).endsWith("tri"))
+    {
+        return NULL;
+    }
 
-    //First, read vert file
-    string line;
-    string fileFormatVert = vertFileNameString.substr(vertFileNameString.length() - 4, 4);
+    //The tri file is parsed on a second thread while this one parses the vert file,
+    //each of them using half of the threads
+    vector<double> coordinates;
+    vector<int> triangles;
+    bool trianglesRead(false);
+    int triThreads = max(1, numThreads / 2);
+    int vertThreads = max(1, numThreads - triThreads);
+    startProgress(QStringList() << triFileName << vertFileName);
+    thread triThread([&]()
+    {
+        trianglesRead = readBlocks(triFileName, [&](const char * begin, const char * end)
+        {
+            return parseTri(begin, end, triThreads, triangles);
+        });
+    });
+    bool coordinatesRead = readBlocks(vertFileName, [&](const char * begin, const char * end)
+    {
+        return parseVert(begin, end, vertThreads, coordinates);
+    });
+    triThread.join();
 
-    int numPoints(0), numLines(0), numFaces(0);
+    if(!coordinatesRead || !trianglesRead)
+    {
+        return NULL;
+    }
 
-    //First I have to get the number of points and number of faces to create the mesh
-    if(fileFormatVert == "vert")
+    //Faces can only be validated once the number of points is known
+    int numPoints = coordinates.size() / 3;
+    for(size_t i = 0; i < triangles.size(); i += 3)
     {
-        //First of all, get number of points by going through all lines
-        // Modified from https://stackoverflow.com/questions/3482064/counting-the-number-of-lines-in-a-text-file
-        ifstream myFile(vertFileNameString);
-        if (myFile.is_open())
-        {
-            while (std::getline(myFile, line)) ++numLines;
-            numPoints = numLines;
-            myFile.close();
-        }else
+        if(!isValidFace(triangles[i], triangles[i + 1], triangles[i + 2], numPoints))
         {
             return NULL;
         }
     }
+
+    Mesh * surface = new Mesh();
+    surface->setData(coordinates, triangles);
+    return surface;
+}
+
+/**
+ * @brief readBlocks Reads a text file as blocks of whole lines. A plain file is
+ *  mapped in memory and given as a single block, or as blocks of
+ *  progressBlockSize bytes when there is a job control. A compressed file is
+ *  decompressed on a second thread, and every block is parsed while the next
+ *  ones are decompressed, keeping only a few of them in memory. The bytes of
+ *  the file read are reported to the job control after every block.
+ * @param fileName Path of the file
+ * @param parseBlock Function called with the limits of every block, in order.
+ *  It returns false to stop reading.
+ * @return true if the whole file was read and every block was parsed, false
+ *  also if the job was cancelled
+ */
+bool FileManager::readBlocks(const QString & fileName,
+                             const function<bool(const char *, const char *)> & parseBlock)
+{
+    if(CompressedStream::isCompressed(fileName))
+    {
+        CompressedStream stream(fileName);
+        if(!stream.isOpen())
+        {
+            return false;
+        }
+        //The progress is the part of the compressed file consumed, the size of
+        //the decompressed content is not known until the end
+        const char * begin = NULL;
+        const char * end = NULL;
+        qint64 position(0);
+        while(stream.nextBlock(begin, end))
+        {
+            if(!parseBlock(begin, end))
+            {
+                return false;
+            }
+            qint64 newPosition = stream.getPosition();
+            if(!addProgress(newPosition - position))
+            {
+                return false;
+            }
+            position = newPosition;
+        }
+        return !stream.hasError();
+    }
+
+    MappedFile myFile(fileName);
+    if(!myFile.isOpen())
+    {
+        return false;
+    }
+    if(control == NULL)
+    {
+        return parseBlock(myFile.begin(), myFile.end());
+    }
+    const char * begin = myFile.begin();
+    while(begin < myFile.end())
+    {
+        const char * end = myFile.end();
+        if(end - begin > progressBlockSize)
+        {
+            end = findLineEnd(begin + progressBlockSize, end);
+            end = (end < myFile.end())? end + 1 : end;
+        }
+        if(!parseBlock(begin, end) || !addProgress(end - begin))
+        {
+            return false;
+        }
+        begin = end;
+    }
+    return true;
+}
+
+/**
+ * @brief parseVert Parse a block of whole lines of a VERT file, one X Y Z
+ *  point per line
+ * @param begin Pointer to the first character of the block
+ * @param end Pointer past the last character of the block
+ * @param numThreads Number of threads used to parse the block
+ * @param coordinates Array where the coordinates of the points are appended
+ * @return true if every line contains a valid point
+ */
+bool FileManager::parseVert(const char * begin, const char * end, int numThreads, vector<double> & coordinates)
+{
+    vector<const char *> chunks = splitInChunks(begin, end, numThreads);
+    vector<int> firstLines = countDataLines(chunks, numThreads, coordinates.size() / 3);
+    int numPoints = firstLines.back();
+
+    coordinates.resize(3 * (size_t)numPoints);
+    return parseChunks(chunks, firstLines, numPoints, 0, numThreads, coordinates.data(), NULL);
+}
+
+/**
+ * @brief parseTri Parse a block of whole lines of a TRI file, one face per
+ *  line with the indexes of its 3 points starting from 1
+ * @param begin Pointer to the first character of the block
+ * @param end Pointer past the last character of the block
+ * @param numThreads Number of threads used to parse the block
+ * @param triangles Array where the indexes of the faces are appended, starting from 0
+ * @return true if every line contains a valid face
+ */
+bool FileManager::parseTri(const char * begin, const char * end, int numThreads, vector<int> & triangles)
+{
+    vector<const char *> chunks = splitInChunks(begin, end, numThreads);
+    vector<int> firstLines = countDataLines(chunks, numThreads, triangles.size() / 3);
+    int numFaces = firstLines.back();
+
+    triangles.resize(3 * (size_t)numFaces);
+    return parseChunks(chunks, firstLines, 0, numFaces, numThreads, NULL, triangles.data());
+}
+
+/**
+ * @brief splitInChunks Splits a text in pieces that can be parsed independently.
+ *  Every piece starts at the beginning of a line and ends after a '\n', except
+ *  the last one which ends with the text.
+ * @param begin Pointer to the first character of the text
+ * @param end Pointer past the last character of the text
+ * @param numThreads Number of threads that will parse the pieces
+ * @return The limits of the pieces, piece i is [chunks[i], chunks[i+1])
+ */
+vector<const char *> FileManager::splitInChunks(const char * begin, const char * end, int numThreads)
+{
+    //Pieces of at least 1 MB, several per thread so that faster threads take more of them
+    const long long minChunkSize = 1 << 20;
+    long long length = end - begin;
+    int numChunks = int(min(4 * (long long)numThreads, length / minChunkSize + 1));
+
+    vector<const char *> chunks;
+    chunks.reserve(numChunks + 1);
+    chunks.push_back(begin);
+    for(int iChunk = 1; iChunk < numChunks; iChunk++)
+    {
+        const char * position = max(begin + length * iChunk / numChunks, chunks.back());
+        const char * lineEnd = findLineEnd(position, end);
+        chunks.push_back((lineEnd < end)? lineEnd + 1 : end);
+    }
+    chunks.push_back(end);
+    return chunks;
+}
+
+/**
+ * @brief countDataLines Counts the lines with data in every piece of a text,
+ *  that is the lines which are not blank or only a comment
+ * @param chunks The limits of the pieces, as returned by splitInChunks
+ * @param numThreads Number of threads used to count the lines
+ * @param linesBefore Number of data lines before the text, when it is a part of a file
+ * @return The number of data lines before every piece, the last element is
+ *  the total number of data lines
+ */
+vector<int> FileManager::countDataLines(const vector<const char *> & chunks, int numThreads, int linesBefore)
+{
+    int numChunks = chunks.size() - 1;
+    vector<int> firstLines(numChunks + 1, 0);
+    parallelFor(0, numChunks, numThreads, 1, [&](int iChunk, int)
+    {
+        int numLines(0);
+        const char * end = chunks[iChunk + 1];
+        for(const char * line = chunks[iChunk]; line < end; )
+        {
+            const char * lineEnd = findLineEnd(line, end);
+            TextParser parser(line, lineEnd);
+            if(!parser.atEnd())
+            {
+                numLines++;
+            }
+            line = lineEnd + 1;
+        }
+        firstLines[iChunk + 1] = numLines;
+    });
+
+    firstLines[0] = linesBefore;
+    for(int iChunk = 0; iChunk < numChunks; iChunk++)
+    {
+        firstLines[iChunk + 1] += firstLines[iChunk];
+    }
+    return firstLines;
+}
+
+/**
+ * @brief parseChunks Parses the data lines of every piece of a text in parallel.
+ *  The first numPoints data lines are points and the next numFaces data lines
+ *  are faces, every piece writes them directly in its position of the arrays.
+ * @param chunks The limits of the pieces, as returned by splitInChunks
+ * @param firstLines The number of data lines before every piece, as returned by countDataLines
+ * @param numPoints Number of data lines that are points
+ * @param numFaces Number of data lines that are faces, written as in TRI files
+ *  with the 3 indexes of the face starting from 1
+ * @param numThreads Number of threads used to parse the pieces
+ * @param coordinates Array of 3 * numPoints elements that receives the points
+ * @param triangles Array of 3 * numFaces elements that receives the faces
+ * @return true if every point and face could be read
+ */
+bool FileManager::parseChunks(const vector<const char *> & chunks, const vector<int> & firstLines,
+                              int numPoints, int numFaces, int numThreads,
+                              double * coordinates, int * triangles)
+{
+    int numChunks = chunks.size() - 1;
+    vector<char> chunkRead(numChunks, 1);
+
+    parallelFor(0, numChunks, numThreads, 1, [&](int iChunk, int)
+    {
+        int dataLine = firstLines[iChunk];
+        const char * end = chunks[iChunk + 1];
+        for(const char * line = chunks[iChunk]; line < end && dataLine < numPoints + numFaces; )
+        {
+            const char * lineEnd = findLineEnd(line, end);
+            TextParser parser(line, lineEnd);
+            line = lineEnd + 1;
+            if(parser.atEnd())
+            {
+                continue;
+            }
+
+            //Anything after the values of the point or face (e.g. colors) is ignored
+            bool lineRead(false);
+            if(dataLine < numPoints)
+            {
+                double * point = coordinates + 3 * (size_t)dataLine;
+                lineRead = parser.readDouble(point[0]) && parser.readDouble(point[1])
+                        && parser.readDouble(point[2]);
+            }
+            else
+            {
+                int * face = triangles + 3 * (size_t)(dataLine - numPoints);
+                lineRead = parser.readInt(face[0]) && parser.readInt(face[1]) && parser.readInt(face[2]);
+                for(int i = 0; i < 3; i++)
+                {
+                    face[i] -= 1;
+                }
+            }
+            if(!lineRead)
+            {
+                chunkRead[iChunk] = 0;
+                return;
+            }
+            dataLine++;
+        }
+    });
+
+    for(int iChunk = 0; iChunk < numChunks; iChunk++)
+    {
+        if(!chunkRead[iChunk])
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief parsePolygonChunks Parses the faces of an OFF file in parallel. Every
+ *  face is a data line with the number of corners followed by their indexes,
+ *  starting from 0. Polygons with more than 3 corners are triangulated, so
+ *  every piece fills its own arrays, which are then appended in order.
+ * @param chunks The limits of the pieces, as returned by splitInChunks
+ * @param firstLines The number of data lines before every piece, as returned by countDataLines
+ * @param numPoints Number of data lines that are points, before the faces
+ * @param numFaces Number of data lines that are faces
+ * @param numThreads Number of threads used to parse the pieces
+ * @param coordinates X Y Z coordinates of the points, already read
+ * @param triangles Array where the indexes of the triangles are appended
+ * @param sourceFaces Array where the face every triangle comes from is appended
+ * @return true if every face could be read and its indexes are valid
+ */
+bool FileManager::parsePolygonChunks(const vector<const char *> & chunks, const vector<int> & firstLines,
+                                     int numPoints, int numFaces, int numThreads, const double * coordinates,
+                                     vector<int> & triangles, vector<int> & sourceFaces)
+{
+    int numChunks = chunks.size() - 1;
+    vector<char> chunkRead(numChunks, 1);
+    vector<vector<int> > chunkTriangles(numChunks);
+    vector<vector<int> > chunkSourceFaces(numChunks);
+
+    parallelFor(0, numChunks, numThreads, 1, [&](int iChunk, int)
+    {
+        Triangulator triangulator(coordinates);
+        vector<int> corners;
+        int dataLine = firstLines[iChunk];
+        const char * end = chunks[iChunk + 1];
+        for(const char * line = chunks[iChunk]; line < end && dataLine < numPoints + numFaces; )
+        {
+            const char * lineEnd = findLineEnd(line, end);
+            TextParser parser(line, lineEnd);
+            line = lineEnd + 1;
+            if(parser.atEnd())
+            {
+                continue;
+            }
+            if(dataLine++ < numPoints)
+            {
+                continue;
+            }
+
+            //Anything after the indexes of the face (e.g. colors) is ignored. Every
+            //corner takes at least 2 characters, which bounds a corrupt count
+            //before the corners are allocated.
+            int numElementsPerFace(0);
+            bool lineRead = parser.readInt(numElementsPerFace) && numElementsPerFace >= 3 &&
+                numElementsPerFace <= (lineEnd - parser.getPosition()) / 2;
+            if(!lineRead)
+            {
+                chunkRead[iChunk] = 0;
+                return;
+            }
+            corners.resize(numElementsPerFace);
+            for(int i = 0; i < numElementsPerFace && lineRead; i++)
+            {
+                lineRead = parser.readInt(corners[i]) && corners[i] >= 0 && corners[i] < numPoints;
+            }
+            if(!lineRead)
+            {
+                chunkRead[iChunk] = 0;
+                return;
+            }
+            triangulator.addPolygon(corners.data(), numElementsPerFace, dataLine - 1 - numPoints,
+                                    chunkTriangles[iChunk], chunkSourceFaces[iChunk]);
+        }
+    });
+
+    //Join the triangles of the pieces at the offsets given by their prefix sum
+    vector<size_t> firstTriangles(numChunks + 1, sourceFaces.size());
+    for(int iChunk = 0; iChunk < numChunks; iChunk++)
+    {
+        if(!chunkRead[iChunk])
+        {
+            return false;
+        }
+        firstTriangles[iChunk + 1] = firstTriangles[iChunk] + chunkSourceFaces[iChunk].size();
+    }
+    triangles.resize(3 * firstTriangles[numChunks]);
+    sourceFaces.resize(firstTriangles[numChunks]);
+    parallelFor(0, numChunks, numThreads, 1, [&](int iChunk, int)
+    {
+        copy(chunkTriangles[iChunk].begin(), chunkTriangles[iChunk].end(),
+             triangles.begin() + 3 * firstTriangles[iChunk]);
+        copy(chunkSourceFaces[iChunk].begin(), chunkSourceFaces[iChunk].end(),
+             sourceFaces.begin() + firstTriangles[iChunk]);
+        vector<int>().swap(chunkTriangles[iChunk]);
+        vector<int>().swap(chunkSourceFaces[iChunk]);
+    });
+    return true;
+}
+
+/**
+ * @brief triangulatePolygons Splits polygonal faces in triangles
+ * @param coordinates X Y Z coordinates of the points
+ * @param numPoints Number of points
+ * @param polygonOffsets Corners of face i are polygonCorners[polygonOffsets[i]] ..
+ *  polygonCorners[polygonOffsets[i+1]-1]
+ * @param polygonCorners Flat array with the indexes of the corners of all the faces
+ * @param triangles Array that receives the indexes of the triangles
+ * @param sourceFaces Array that receives the face every triangle comes from
+ * @return true if every face has at least 3 corners and its indexes are valid
+ */
+bool FileManager::triangulatePolygons(const double * coordinates, int numPoints,
+                                      const vector<int> & polygonOffsets, const vector<int> & polygonCorners,
+                                      vector<int> & triangles, vector<int> & sourceFaces)
+{
+    int numFaces = polygonOffsets.size() - 1;
+    Triangulator triangulator(coordinates);
+    triangles.reserve(3 * (size_t)numFaces);
+    sourceFaces.reserve(numFaces);
+    for(size_t i = 0; i < polygonCorners.size(); i++)
+    {
+        if(polygonCorners[i] < 0 || polygonCorners[i] >= numPoints)
+        {
+            return false;
+        }
+    }
+    for(int iFace = 0; iFace < numFaces; iFace++)
+    {
+        int numCorners = polygonOffsets[iFace + 1] - polygonOffsets[iFace];
+        if(numCorners < 3)
+        {
+            return false;
+        }
+        triangulator.addPolygon(polygonCorners.data() + polygonOffsets[iFace], numCorners, iFace,
+                                triangles, sourceFaces);
+    }
+    return true;
+}
+
+/**
+ * @brief buildPolygonalMesh Creates a mesh from triangulated faces, keeping the
+ *  face every triangle comes from only if some face was split
+ * @param coordinates X Y Z coordinates of the points, moved to the mesh
+ * @param triangles Indexes of the triangles, moved to the mesh
+ * @param sourceFaces Face every triangle comes from, moved to the mesh
+ * @param numFaces Number of faces in the file
+ * @return A pointer to an object of the Mesh class
+ */
+Mesh * FileManager::buildPolygonalMesh(vector<double> & coordinates, vector<int> & triangles,
+                                       vector<int> & sourceFaces, int numFaces)
+{
+    Mesh * surface = new Mesh();
+    surface->setData(coordinates, triangles);
+    if(int(sourceFaces.size()) != numFaces)
+    {
+        surface->setSourceFaces(sourceFaces);
+    }
+    return surface;
+}
+
+/**
+ * @brief isValidFace Checks that the vertexes of a face exist in the mesh
+ * @param f0 Index of the first vertex of the face
+ * @param f1 Index of the second vertex of the face
+ * @param f2 Index of the third vertex of the face
+ * @param numPoints Number of vertexes of the mesh
+ * @return true if the three indexes are between 0 and numPoints - 1
+ */
+bool FileManager::isValidFace(int f0, int f1, int f2, int numPoints)
+{
+    return f0 >= 0 && f0 < numPoints
+        && f1 >= 0 && f1 < numPoints
+        && f2 >= 0 && f2 < numPoints;
+}
+
+/**
+ * @brief readPLY Read a PLY file, in ASCII or binary format
+ * @param plyFile Pointer to QFile for the PLY file selected from the GUI
+ * @return A pointer to an object of the Mesh class containing read faces and vertexes
+ */
+Mesh * FileManager::readPLY(QFile * plyFile)
+{
+    QString plyFileName = plyFile->fileName();
+    if(!plyFileName.endsWith("ply"))
+    {
+        return NULL;
+    }
+
+    MappedFile myFile(plyFileName);
+    if(!myFile.isOpen())
+    {
+        return NULL;
+    }
+
+    //The elements are parsed at once, so the progress is only reported at the end
+    startProgress(QStringList(plyFileName));
+    Mesh * surface = parsePLY(myFile.begin(), myFile.end());
+    addProgress(myFile.size());
+    return surface;
+}
+
+/**
+ * @brief parsePLY Parse the content of a PLY file. Only the x, y and z
+ *  properties of the vertexes and the vertex indexes of the faces are read,
+ *  other properties and elements are skipped. Faces with more than 3 corners
+ *  are split in triangles.
+ * @param begin Pointer to the first character of the file
+ * @param end Pointer past the last character of the file
+ * @return A pointer to an object of the Mesh class containing read faces and vertexes,
+ *  NULL if the content is not a valid PLY file
+ */
+Mesh * FileManager::parsePLY(const char * begin, const char * end)
+{
+    PlyHeader header;
+    if(!header.parse(begin, end))
+    {
+        return NULL;
+    }
+
+    //Find the properties that are read
+    const vector<PlyElement> & elements = header.getElements();
+    int numPoints(-1), numFaces(0);
+    int coordinateProperties[3] = {-1, -1, -1};
+    int indexesProperty(-1);
+    for(unsigned int i = 0; i < elements.size(); i++)
+    {
+        if(elements[i].name == "vertex")
+        {
+            numPoints = elements[i].count;
+            coordinateProperties[0] = PlyHeader::findProperty(elements[i], "x");
+            coordinateProperties[1] = PlyHeader::findProperty(elements[i], "y");
+            coordinateProperties[2] = PlyHeader::findProperty(elements[i], "z");
+        }
+        else if(elements[i].name == "face")
+        {
+            numFaces = elements[i].count;
+            indexesProperty = PlyHeader::findProperty(elements[i], "vertex_indices");
+            if(indexesProperty < 0)
+            {
+                indexesProperty = PlyHeader::findProperty(elements[i], "vertex_index");
+            }
+            if(indexesProperty < 0 || !elements[i].properties[indexesProperty].isList)
+            {
+                return NULL;
+            }
+        }
+    }
+    if(numPoints < 0 || coordinateProperties[0] < 0 || coordinateProperties[1] < 0 || coordinateProperties[2] < 0)
+    {
+        return NULL;
+    }
+
+    //The counts of a corrupt header must not allocate more than the data can
+    //hold, every face has at least 3 corners. The last value of an ASCII file
+    //may have no separator after it.
+    long long minDataSize = 0;
+    for(unsigned int i = 0; i < elements.size(); i++)
+    {
+        bool isFace = (elements[i].name == "face");
+        minDataSize += elements[i].count * header.getMinimumItemSize(elements[i], isFace? indexesProperty : -1, 3);
+    }
+    if(minDataSize > end - header.getDataStart() + (header.getFormat() == PLY_ASCII? 1 : 0))
+    {
+        return NULL;
+    }
+
+    //Faces are kept as polygons until all the elements are read, since the
+    //vertexes could come after them
+    vector<double> coordinates;
+    vector<int> polygonOffsets((size_t)numFaces + 1, 0);
+    vector<int> polygonCorners;
+    coordinates.resize(3 * (size_t)numPoints);
+    polygonCorners.reserve(3 * (size_t)numFaces);
+
+    bool contentRead(false);
+    if(header.getFormat() == PLY_ASCII)
+    {
+        contentRead = parsePLYAscii(header, end, coordinateProperties, indexesProperty,
+                                    coordinates.data(), polygonOffsets, polygonCorners);
+    }
     else
+    {
+        bool fileIsLittleEndian = (header.getFormat() == PLY_BINARY_LITTLE_ENDIAN);
+        bool swapBytes = (fileIsLittleEndian != (Q_BYTE_ORDER == Q_LITTLE_ENDIAN));
+        contentRead = parsePLYBinary(header, end, swapBytes, coordinateProperties, indexesProperty,
+                                     coordinates.data(), polygonOffsets, polygonCorners);
+    }
+
+    vector<int> triangles;
+    vector<int> sourceFaces;
+    if(!contentRead || !triangulatePolygons(coordinates.data(), numPoints, polygonOffsets, polygonCorners,
+                                            triangles, sourceFaces))
+    {
+        return NULL;
+    }
+    return buildPolygonalMesh(coordinates, triangles, sourceFaces, numFaces);
+}
+
+/**
+ * @brief parsePLYAscii Parse the elements of an ASCII PLY file
+ * @param header The header of the file
+ * @param end Pointer past the last character of the file
+ * @param coordinateProperties Positions of the x, y and z properties in the vertex element
+ * @param indexesProperty Position of the vertex indexes list in the face element
+ * @param coordinates Array of 3 * number of vertexes elements that receives the points
+ * @param polygonOffsets Array of number of faces + 1 elements that receives the
+ *  offsets of the corners of every face
+ * @param polygonCorners Array where the indexes of the corners of the faces are appended
+ * @return true if every element could be read
+ */
+bool FileManager::parsePLYAscii(PlyHeader & header, const char * end, const int * coordinateProperties,
+                                int indexesProperty, double * coordinates,
+                                vector<int> & polygonOffsets, vector<int> & polygonCorners)
+{
+    TextParser parser(header.getDataStart(), end);
+    const vector<PlyElement> & elements = header.getElements();
+    double value(0);
+
+    for(unsigned int iElement = 0; iElement < elements.size(); iElement++)
+    {
+        const PlyElement & element = elements[iElement];
+        bool isVertex = (element.name == "vertex");
+        bool isFace = (element.name == "face");
+        for(int iItem = 0; iItem < element.count; iItem++)
+        {
+            for(unsigned int iProperty = 0; iProperty < element.properties.size(); iProperty++)
+            {
+                if(!element.properties[iProperty].isList)
+                {
+                    if(!parser.readDouble(value))
+                    {
+                        return false;
+                    }
+                    for(int i = 0; isVertex && i < 3; i++)
+                    {
+                        if(int(iProperty) == coordinateProperties[i])
+                        {
+                            coordinates[3 * (size_t)iItem + i] = value;
+                        }
+                    }
+                    continue;
+                }
+
+                int numValues(0);
+                if(!parser.readInt(numValues) || numValues < 0)
+                {
+                    return false;
+                }
+                bool isIndexes = isFace && int(iProperty) == indexesProperty;
+                for(int i = 0; i < numValues; i++)
+                {
+                    if(!parser.readDouble(value))
+                    {
+                        return false;
+                    }
+                    if(isIndexes)
+                    {
+                        polygonCorners.push_back(int(value));
+                    }
+                }
+                if(isIndexes)
+                {
+                    polygonOffsets[iItem + 1] = polygonCorners.size();
+                }
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief parsePLYBinary Parse the elements of a binary PLY file. Vertexes have
+ *  a fixed size, so they are read in parallel, or copied at once when they
+ *  only contain x, y and z as doubles in the byte order of the machine.
+ * @param header The header of the file
+ * @param end Pointer past the last character of the file
+ * @param swapBytes true if the byte order of the file is not the one of the machine
+ * @param coordinateProperties Positions of the x, y and z properties in the vertex element
+ * @param indexesProperty Position of the vertex indexes list in the face element
+ * @param coordinates Array of 3 * number of vertexes elements that receives the points
+ * @param polygonOffsets Array of number of faces + 1 elements that receives the
+ *  offsets of the corners of every face
+ * @param polygonCorners Array where the indexes of the corners of the faces are appended
+ * @return true if every element could be read
+ */
+bool FileManager::parsePLYBinary(PlyHeader & header, const char * end, bool swapBytes,
+                                 const int * coordinateProperties, int indexesProperty,
+                                 double * coordinates, vector<int> & polygonOffsets,
+                                 vector<int> & polygonCorners)
+{
+    const char * position = header.getDataStart();
+    const vector<PlyElement> & elements = header.getElements();
+
+    for(unsigned int iElement = 0; iElement < elements.size(); iElement++)
+    {
+        const PlyElement & element = elements[iElement];
+        int itemSize = PlyHeader::getFixedSize(element);
+        bool isVertex = (element.name == "vertex");
+        bool isFace = (element.name == "face");
+
+        if(itemSize >= 0)
+        {
+            //Every item has the same size, the whole block is skipped or read at once
+            qint64 blockSize = (qint64)itemSize * element.count;
+            if(blockSize > end - position)
+            {
+                return false;
+            }
+            if(isVertex)
+            {
+                int offsets[3];
+                PlyType types[3];
+                for(int i = 0; i < 3; i++)
+                {
+                    int property = coordinateProperties[i];
+                    types[i] = element.properties[property].type;
+                    offsets[i] = 0;
+                    for(int j = 0; j < property; j++)
+                    {
+                        offsets[i] += PlyHeader::getTypeSize(element.properties[j].type);
+                    }
+                }
+
+                bool isPlainBlock = !swapBytes && itemSize == 3 * int(sizeof(double))
+                        && types[0] == PLY_FLOAT64 && types[1] == PLY_FLOAT64 && types[2] == PLY_FLOAT64
+                        && offsets[0] == 0 && offsets[1] == 8 && offsets[2] == 16;
+                if(isPlainBlock)
+                {
+                    memcpy(coordinates, position, blockSize);
+                }
+                else
+                {
+                    const char * block = position;
+                    parallelFor(0, element.count, numThreads, 4096, [&](int iPoint, int)
+                    {
+                        const char * item = block + (qint64)itemSize * iPoint;
+                        for(int i = 0; i < 3; i++)
+                        {
+                            coordinates[3 * (size_t)iPoint + i] =
+                                    PlyHeader::readValue(item + offsets[i], types[i], swapBytes);
+                        }
+                    });
+                }
+            }
+            position += blockSize;
+            continue;
+        }
+
+        //Items with lists have different sizes and are read one after the other
+        for(int iItem = 0; iItem < element.count; iItem++)
+        {
+            for(unsigned int iProperty = 0; iProperty < element.properties.size(); iProperty++)
+            {
+                const PlyProperty & property = element.properties[iProperty];
+                int valueSize = PlyHeader::getTypeSize(property.type);
+                if(!property.isList)
+                {
+                    if(valueSize > end - position)
+                    {
+                        return false;
+                    }
+                    for(int i = 0; isVertex && i < 3; i++)
+                    {
+                        if(int(iProperty) == coordinateProperties[i])
+                        {
+                            coordinates[3 * (size_t)iItem + i] =
+                                    PlyHeader::readValue(position, property.type, swapBytes);
+                        }
+                    }
+                    position += valueSize;
+                    continue;
+                }
+
+                int countSize = PlyHeader::getTypeSize(property.countType);
+                if(countSize > end - position)
+                {
+                    return false;
+                }
+                double numValues = PlyHeader::readValue(position, property.countType, swapBytes);
+                position += countSize;
+                if(numValues < 0 || numValues * valueSize > end - position)
+                {
+                    return false;
+                }
+                if(isFace && int(iProperty) == indexesProperty)
+                {
+                    for(int i = 0; i < int(numValues); i++)
+                    {
+                        polygonCorners.push_back(
+                                int(PlyHeader::readValue(position + i * valueSize, property.type, swapBytes)));
+                    }
+                    polygonOffsets[iItem + 1] = polygonCorners.size();
+                }
+                position += int(numValues) * valueSize;
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief readSTL Read an STL file, in binary or ASCII format. STL stores the
+ *  three corners of every triangle separately, so coincident corners are
+ *  welded into shared vertexes.
+ * @param stlFile Pointer to QFile for the STL file selected from the GUI
+ * @param weldTolerance Corners whose coordinates round to the same multiple of
+ *  it are merged. With 0 only identical corners are merged.
+ * @return A pointer to an object of the Mesh class containing read faces and vertexes
+ */
+Mesh * FileManager::readSTL(QFile * stlFile, double weldTolerance)
+{
+    QString stlFileName = stlFile->fileName();
+    if(!stlFileName.endsWith("stl"))
     {
         return NULL;
     }
 
-    string fileFormatTri = triFileNameString.substr(triFileNameString.length() - 3, 3);
-    numLines = 0;
+    MappedFile myFile(stlFileName);
+    if(!myFile.isOpen())
+    {
+        return NULL;
+    }
+
+    //The triangles are parsed at once, so the progress is only reported at the end
+    startProgress(QStringList(stlFileName));
+    Mesh * surface = parseSTL(myFile.begin(), myFile.end(), weldTolerance);
+    addProgress(myFile.size());
+    return surface;
+}
+
+/**
+ * @brief parseSTL Parse the content of an STL file. Triangles that become
+ *  degenerate after welding their corners are dropped.
+ * @param begin Pointer to the first character of the file
+ * @param end Pointer past the last character of the file
+ * @param weldTolerance Corners whose coordinates round to the same multiple of
+ *  it are merged. With 0 only identical corners are merged.
+ * @return A pointer to an object of the Mesh class containing read faces and vertexes,
+ *  NULL if the content is not a valid STL file
+ */
+Mesh * FileManager::parseSTL(const char * begin, const char * end, double weldTolerance)
+{
+    //Binary files have an 80 bytes header, the number of triangles and 50 bytes per triangle
+    const qint64 headerSize = 84;
+    const qint64 triangleSize = 50;
+    qint64 length = end - begin;
+    quint32 numTriangles(0);
+    if(length >= headerSize)
+    {
+        memcpy(&numTriangles, begin + 80, sizeof(numTriangles));
+        if(Q_BYTE_ORDER == Q_BIG_ENDIAN)
+        {
+            reverse(reinterpret_cast<char *>(&numTriangles), reinterpret_cast<char *>(&numTriangles) + 4);
+        }
+    }
+    bool isBinary = (length >= headerSize && length == headerSize + triangleSize * (qint64)numTriangles);
+
+    vector<int> triangles;
+    int corners[3];
+    if(isBinary)
+    {
+        if(numTriangles > quint32(numeric_limits<int>::max() / 3))
+        {
+            return NULL;
+        }
+        //Closed meshes have about half as many vertexes as triangles
+        VertexWelder welder(weldTolerance, numTriangles / 2 + 16);
+        triangles.reserve(3 * (size_t)numTriangles);
+        const char * record = begin + headerSize;
+        for(quint32 iTriangle = 0; iTriangle < numTriangles; iTriangle++, record += triangleSize)
+        {
+            //The record has the normal, the three corners and 2 bytes of attributes
+            float values[9];
+            memcpy(values, record + 12, sizeof(values));
+            if(Q_BYTE_ORDER == Q_BIG_ENDIAN)
+            {
+                for(int i = 0; i < 9; i++)
+                {
+                    char * bytes = reinterpret_cast<char *>(values + i);
+                    reverse(bytes, bytes + 4);
+                }
+            }
+            for(int i = 0; i < 3; i++)
+            {
+                corners[i] = welder.addVertex(values[3 * i], values[3 * i + 1], values[3 * i + 2]);
+            }
+            addWeldedTriangle(corners, triangles);
+        }
+        return buildWeldedMesh(welder, triangles);
+    }
 
-    if(fileFormatTri == "tri")
+    //ASCII files list the corners of every facet as "vertex x y z"
+    TextParser parser(begin, end);
+    const char * word = NULL;
+    int wordLength(0);
+    if(!parser.readWord(word, wordLength) || string(word, wordLength) != "solid")
     {
-        //First of all, get number of points by going through all lines
-        // Modified from https://stackoverflow.com/questions/3482064/counting-the-number-of-lines-in-a-text-file
-        ifstream myFile(triFileNameString);
-        if (myFile.is_open())
+        return NULL;
+    }
+    VertexWelder welder(weldTolerance, int(min<qint64>(length / 500 + 16, numeric_limits<int>::max() / 4)));
+    int numCorners(0);
+    double x(0), y(0), z(0);
+    while(parser.readWord(word, wordLength))
+    {
+        if(wordLength != 6 || string(word, wordLength) != "vertex")
         {
-            while (std::getline(myFile, line)) ++numLines;
-            numFaces = numLines;
-            myFile.close();
-        }else
+            continue;
+        }
+        if(!parser.readDouble(x) || !parser.readDouble(y) || !parser.readDouble(z))
         {
             return NULL;
         }
+        corners[numCorners++] = welder.addVertex(x, y, z);
+        if(numCorners == 3)
+        {
+            addWeldedTriangle(corners, triangles);
+            numCorners = 0;
+        }
     }
-    else
+    if(numCorners != 0)
     {
         return NULL;
     }
+    return buildWeldedMesh(welder, triangles);
+}
+
+/**
+ * @brief addWeldedTriangle Adds a triangle whose corners have been welded,
+ *  unless two of them became the same vertex
+ * @param corners Indexes of the 3 welded vertexes of the triangle
+ * @param triangles Array where the triangle is appended
+ */
+void FileManager::addWeldedTriangle(const int * corners, vector<int> & triangles)
+{
+    if(corners[0] == corners[1] || corners[1] == corners[2] || corners[0] == corners[2])
+    {
+        return;
+    }
+    triangles.push_back(corners[0]);
+    triangles.push_back(corners[1]);
+    triangles.push_back(corners[2]);
+}
+
+/**
+ * @brief buildWeldedMesh Creates a mesh with the vertexes of a welder
+ * @param welder The welder with the vertexes, its coordinates are moved to the mesh
+ * @param triangles Indexes of the faces, moved to the mesh
+ * @return A pointer to an object of the Mesh class
+ */
+Mesh * FileManager::buildWeldedMesh(VertexWelder & welder, vector<int> & triangles)
+{
     Mesh * surface = new Mesh();
-    //Now read the points and faces and put them in the mesh
-    //If this point is reached, both files were read correctly before, so no need for checking format again
-    unsigned int delimiterPos_1(0), delimiterPos_2(0);
-    double x(0), y(0), z(0);
+    surface->setData(welder.getCoordinates(), triangles);
+    return surface;
+}
 
-    ifstream myVertFile (vertFileNameString);
-    if (myVertFile.is_open())
+/**
+ * @brief writePLY Write a mesh to a PLY file. Vertexes are written as doubles
+ *  and faces as lists of ints.
+ * @param mesh The mesh to write
+ * @param plyFile Pointer to QFile for the PLY file to write
+ * @param binary true to write the data in binary with the byte order of the
+ *  machine, false to write it as text
+ * @return true if the file could be written
+ */
+bool FileManager::writePLY(Mesh * mesh, QFile * plyFile, bool binary)
+{
+    if(mesh == NULL || !plyFile->open(QIODevice::WriteOnly))
+    {
+        return false;
+    }
+
+    int numPoints = mesh->getNumVertexes();
+    int numFaces = mesh->getNumFaces();
+    const double * coordinates = mesh->getCoordinates();
+    const int * triangles = mesh->getTriangles();
+
+    string format = !binary? "ascii"
+            : (Q_BYTE_ORDER == Q_LITTLE_ENDIAN)? "binary_little_endian" : "binary_big_endian";
+    string header = "ply\nformat " + format + " 1.0\n"
+            + "element vertex " + to_string(numPoints) + "\n"
+            + "property double x\nproperty double y\nproperty double z\n"
+            + "element face " + to_string(numFaces) + "\n"
+            + "property list uchar int vertex_indices\nend_header\n";
+    bool written = plyFile->write(header.data(), header.size()) == qint64(header.size());
+
+    //Data is written in blocks to keep the memory used bounded
+    const int blockSize = 1 << 16;
+    string block;
+    if(binary)
     {
-        for(int iPoint=0; iPoint < numPoints; iPoint++)
+        written = written && plyFile->write(reinterpret_cast<const char *>(coordinates),
+                                            3 * (qint64)numPoints * sizeof(double))
+                == 3 * (qint64)numPoints * qint64(sizeof(double));
+        const unsigned char numElementsPerFace = 3;
+        for(int iFace = 0; iFace < numFaces && written; iFace++)
         {
-            getline(myVertFile, line);
-            delimiterPos_1 = line.find(" ", 0);
-            x = atof(line.substr(0,delimiterPos_1).c_str());
-            delimiterPos_2 = line.find(" ", delimiterPos_1+1);
-            y = atof(line.substr(delimiterPos_1+1,delimiterPos_2 - (delimiterPos_1 + 1)).c_str());
-            z = atof(line.substr(delimiterPos_2+1).c_str());
+            block.append(reinterpret_cast<const char *>(&numElementsPerFace), 1);
+            block.append(reinterpret_cast<const char *>(triangles + 3 * (size_t)iFace), 3 * sizeof(int));
+            if(block.size() >= size_t(blockSize) || iFace == numFaces - 1)
+            {
+                written = plyFile->write(block.data(), block.size()) == qint64(block.size());
+                block.clear();
+            }
+        }
+    }
+    else
+    {
+        char line[128];
+        for(int iLine = 0; iLine < numPoints + numFaces && written; iLine++)
+        {
+            int length(0);
+            if(iLine < numPoints)
+            {
+                const double * point = coordinates + 3 * (size_t)iLine;
+                length = snprintf(line, sizeof(line), "%.17g %.17g %.17g\n", point[0], point[1], point[2]);
+            }
+            else
+            {
+                const int * face = triangles + 3 * (size_t)(iLine - numPoints);
+                length = snprintf(line, sizeof(line), "3 %d %d %d\n", face[0], face[1], face[2]);
+            }
+            block.append(line, length);
+            if(block.size() >= size_t(blockSize) || iLine == numPoints + numFaces - 1)
+            {
+                written = plyFile->write(block.data(), block.size()) == qint64(block.size());
+                block.clear();
+            }
+        }
+    }
 
-            Vertex  * pointVertex = new Vertex;
-            pointVertex->setCoordinates(x,y,z);
-            pointVertex->setIndex(iPoint);
-            surface->addNewVertex(pointVertex);
+    plyFile->close();
+    return written;
+}
+
+/**
+ * @brief getCacheFileName Name of the binary cache of a mesh file
+ * @param sourceFileName Name of the OFF file, or of the VERT file for TRI and VERT meshes
+ * @return The name of the cache file, next to the source file
+ */
+QString FileManager::getCacheFileName(const QString & sourceFileName)
+{
+    return sourceFileName + ".hmc";
+}
+
+/**
+ * @brief detectMeshType Finds the format of a mesh file from its extension,
+ *  after removing the one of the compression. The extensions are lower case,
+ *  as the readers require, and only OFF, TRI and VERT files may be compressed.
+ * @param fileName Path of the file. For TRI and VERT meshes, either of them.
+ * @param type Receives the format
+ * @param file1 Receives the first file to read, the TRI file for TRIVERT meshes
+ * @param file2 Receives the VERT file for TRIVERT meshes, next to the TRI file
+ *  and with the same base name, and an empty string otherwise
+ * @return false if the extension is not one of a mesh file
+ */
+bool FileManager::detectMeshType(const QString & fileName, MeshType & type, QString & file1, QString & file2)
+{
+    QString uncompressed = CompressedStream::getUncompressedName(fileName);
+    QString compression = fileName.mid(uncompressed.length());
+    QString extension = QFileInfo(uncompressed).suffix();
+    QString base = uncompressed.left(uncompressed.length() - extension.length());
+    file1 = fileName;
+    file2 = QString();
+    if(extension == "tri" || extension == "vert")
+    {
+        type = TRIVERT;
+        file1 = base + "tri" + compression;
+        file2 = base + "vert" + compression;
+        return true;
+    }
+    if(extension == "off")
+    {
+        type = OFF;
+        return true;
+    }
+    //PLY and STL files are mapped in memory, they are never decompressed
+    if(extension == "ply" && compression.isEmpty())
+    {
+        type = PLY;
+        return true;
+    }
+    if(extension == "stl" && compression.isEmpty())
+    {
+        type = STL;
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief getSourceFiles Files a mesh is read from, the first one names its binary cache
+ * @param type The format of the mesh files
+ * @param file1 The first file, the TRI file for TRIVERT meshes
+ * @param file2 The VERT file for TRIVERT meshes
+ * @return The VERT and TRI files for TRIVERT meshes, file1 otherwise
+ */
+QStringList FileManager::getSourceFiles(MeshType type, const QString & file1, const QString & file2)
+{
+    QStringList sources;
+    if(type == TRIVERT)
+    {
+        sources << file2 << file1;
+    }
+    else
+    {
+        sources << file1;
+    }
+    return sources;
+}
+
+/**
+ * @brief readMesh Reads a mesh from its binary cache, if it is valid, or
+ *  from its files with the reader of its format. The cache is not written,
+ *  which callers do with writeMeshCache when they choose to.
+ * @param type The format of the mesh files
+ * @param file1 The first file, the TRI file for TRIVERT meshes
+ * @param file2 The VERT file for TRIVERT meshes
+ * @param useCache false to always parse the files
+ * @param fromCache Receives true if the mesh was read from its cache, it may be NULL
+ * @return A pointer to an object of the Mesh class, NULL if the files could
+ *  not be read or the read was cancelled
+ */
+Mesh * FileManager::readMesh(MeshType type, const QString & file1, const QString & file2,
+                             bool useCache, bool * fromCache)
+{
+    Mesh * mesh = NULL;
+    if(useCache)
+    {
+        QStringList sources = getSourceFiles(type, file1, file2);
+        mesh = readMeshCache(getCacheFileName(sources[0]), sources);
+    }
+    if(fromCache != NULL)
+    {
+        *fromCache = (mesh != NULL);
+    }
+    if(mesh != NULL)
+    {
+        return mesh;
+    }
+
+    QFile file(file1);
+    if(type == TRIVERT)
+    {
+        QFile vertFile(file2);
+        mesh = readTriVert(&file, &vertFile);
+    }
+    else if(type == OFF)
+    {
+        mesh = readOFF(&file);
+    }
+    else if(type == PLY)
+    {
+        mesh = readPLY(&file);
+    }
+    else if(type == STL)
+    {
+        mesh = readSTL(&file);
+    }
+    return mesh;
+}
+
+/**
+ * @brief readSourceSignature Gets the size and modification time of the source files of a cache
+ * @param sourceFileNames Names of up to 2 source files
+ * @param header Header whose sourceSizes and sourceModified are filled
+ * @return false if there are more than 2 source files or one of them does not exist
+ */
+bool FileManager::readSourceSignature(const QStringList & sourceFileNames, MeshCacheHeader & header)
+{
+    if(sourceFileNames.size() > 2)
+    {
+        return false;
+    }
+    for(int i = 0; i < 2; i++)
+    {
+        header.sourceSizes[i] = 0;
+        header.sourceModified[i] = 0;
+        if(i < int(sourceFileNames.size()))
+        {
+            QFileInfo info(sourceFileNames[i]);
+            if(!info.exists())
+            {
+                return false;
+            }
+            header.sourceSizes[i] = info.size();
+            header.sourceModified[i] = info.lastModified().toMSecsSinceEpoch();
         }
-        myVertFile.close();
+    }
+    return true;
+}
+
+/**
+ * @brief writeMeshCache Writes a mesh in the binary cache format. The file is
+ *  replaced only once it has been completely written.
+ * @param mesh The mesh to write, its adjacency is built if it was not already
+ * @param cacheFileName Name of the cache file
+ * @param sourceFileNames Names of the files the mesh was read from, up to 2
+ * @param singlePrecision true to store the coordinates as float instead of double
+ * @return true if the file could be written
+ */
+bool FileManager::writeMeshCache(Mesh * mesh, const QString & cacheFileName,
+                                 const QStringList & sourceFileNames, bool singlePrecision)
+{
+    MeshCacheHeader header;
+    memset(&header, 0, sizeof(header));
+    if(mesh == NULL || !readSourceSignature(sourceFileNames, header))
+    {
+        return false;
+    }
+
+    int numPoints = mesh->getNumVertexes();
+    int numFaces = mesh->getNumFaces();
+    Adjacency * adjacency = mesh->getAdjacency();
+    memcpy(header.magic, MESH_CACHE_MAGIC, sizeof(header.magic));
+    header.version = MESH_CACHE_VERSION;
+    header.flags = MESH_CACHE_ADJACENCY | MESH_CACHE_BOUNDING_BOX
+            | (singlePrecision? MESH_CACHE_SINGLE_PRECISION : 0)
+            | (mesh->hasSourceFaces()? MESH_CACHE_SOURCE_FACES : 0);
+    header.byteOrder = MESH_CACHE_BYTE_ORDER;
+    header.numVertexes = numPoints;
+    header.numFaces = numFaces;
+    header.numNeighbours = adjacency->getAllNeighbours().size();
+    header.numVertexFaces = adjacency->getAllFaces().size();
+    mesh->getBoundingBox(header.boundingBox, header.boundingBox + 3);
+
+    QSaveFile myFile(cacheFileName);
+    if(!myFile.open(QIODevice::WriteOnly))
+    {
+        return false;
+    }
+
+    //Every section is padded with zeros up to a multiple of 8 bytes
+    const char padding[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+    qint64 written(0);
+    auto writeSection = [&](const void * data, qint64 size)
+    {
+        written += myFile.write(static_cast<const char *>(data), size);
+        qint64 paddingSize = alignSection(size) - size;
+        written += myFile.write(padding, paddingSize);
+        return alignSection(size);
+    };
+
+    qint64 expected = writeSection(&header, sizeof(header));
+    if(singlePrecision)
+    {
+        vector<float> coordinates(mesh->getCoordinates(), mesh->getCoordinates() + 3 * (size_t)numPoints);
+        expected += writeSection(coordinates.data(), coordinates.size() * sizeof(float));
     }
     else
+    {
+        expected += writeSection(mesh->getCoordinates(), 3 * (qint64)numPoints * sizeof(double));
+    }
+    expected += writeSection(mesh->getTriangles(), 3 * (qint64)numFaces * sizeof(int));
+    expected += writeSection(adjacency->getNeighbourOffsets().data(), (numPoints + 1) * (qint64)sizeof(int));
+    expected += writeSection(adjacency->getAllNeighbours().data(), header.numNeighbours * sizeof(int));
+    expected += writeSection(adjacency->getFaceOffsets().data(), (numPoints + 1) * (qint64)sizeof(int));
+    expected += writeSection(adjacency->getAllFaces().data(), header.numVertexFaces * sizeof(int));
+    if(mesh->hasSourceFaces())
+    {
+        expected += writeSection(mesh->getSourceFaces(), (qint64)numFaces * sizeof(int));
+    }
+
+    if(written != expected)
+    {
+        myFile.cancelWriting();
+    }
+    return myFile.commit();
+}
+
+/**
+ * @brief readMeshCache Reads a mesh from a binary cache file. The file is
+ *  mapped in memory and its sections are copied directly into the mesh.
+ * @param cacheFileName Name of the cache file
+ * @param sourceFileNames Names of the files the mesh was read from, up to 2
+ * @return A pointer to an object of the Mesh class, NULL if the file does not
+ *  exist, is not valid or does not correspond to the current source files
+ */
+Mesh * FileManager::readMeshCache(const QString & cacheFileName, const QStringList & sourceFileNames)
+{
+    MeshCacheHeader signature;
+    if(!QFileInfo(cacheFileName).exists() || !readSourceSignature(sourceFileNames, signature))
+    {
+        return NULL;
+    }
+    MappedFile myFile(cacheFileName);
+    if(!myFile.isOpen() || myFile.size() < qint64(sizeof(MeshCacheHeader)))
+    {
+        return NULL;
+    }
+
+    MeshCacheHeader header;
+    memcpy(&header, myFile.begin(), sizeof(header));
+    if(memcmp(header.magic, MESH_CACHE_MAGIC, sizeof(header.magic)) != 0
+            || header.version != MESH_CACHE_VERSION
+            || header.byteOrder != MESH_CACHE_BYTE_ORDER
+            || header.numVertexes > quint32(numeric_limits<int>::max() / 3)
+            || header.numFaces > quint32(numeric_limits<int>::max() / 3)
+            || header.numNeighbours > quint64(numeric_limits<int>::max())
+            || header.numVertexFaces > quint64(numeric_limits<int>::max()))
     {
         return NULL;
     }
+    for(int i = 0; i < 2; i++)
+    {
+        if(header.sourceSizes[i] != signature.sourceSizes[i]
+                || header.sourceModified[i] != signature.sourceModified[i])
+        {
+            return NULL;
+        }
+    }
 
+    //Position and size of every section
+    int numPoints = header.numVertexes;
+    int numFaces = header.numFaces;
+    bool singlePrecision = (header.flags & MESH_CACHE_SINGLE_PRECISION) != 0;
+    bool withAdjacency = (header.flags & MESH_CACHE_ADJACENCY) != 0;
+    bool withSourceFaces = (header.flags & MESH_CACHE_SOURCE_FACES) != 0;
+    qint64 coordinatesSize = 3 * (qint64)numPoints * (singlePrecision? sizeof(float) : sizeof(double));
+    qint64 trianglesSize = 3 * (qint64)numFaces * sizeof(int);
+    qint64 offsetsSize = (numPoints + 1) * (qint64)sizeof(int);
+    qint64 neighboursSize = header.numNeighbours * sizeof(int);
+    qint64 facesSize = header.numVertexFaces * sizeof(int);
 
-    int f0(0), f1(0), f2(0);
-    delimiterPos_1 = 0;
-    delimiterPos_2 = 0;
+    qint64 coordinatesStart = alignSection(sizeof(header));
+    qint64 trianglesStart = coordinatesStart + alignSection(coordinatesSize);
+    qint64 neighbourOffsetsStart = trianglesStart + alignSection(trianglesSize);
+    qint64 neighboursStart = neighbourOffsetsStart + alignSection(offsetsSize);
+    qint64 faceOffsetsStart = neighboursStart + alignSection(neighboursSize);
+    qint64 facesStart = faceOffsetsStart + alignSection(offsetsSize);
+    qint64 sourceFacesStart = withAdjacency? facesStart + alignSection(facesSize) : neighbourOffsetsStart;
+    qint64 fileEnd = sourceFacesStart + (withSourceFaces? alignSection(numFaces * (qint64)sizeof(int)) : 0);
+    if(myFile.size() != fileEnd)
+    {
+        return NULL;
+    }
 
-    ifstream myTriFile (triFileNameString);
-    if (myTriFile.is_open())
+    const char * data = myFile.begin();
+    vector<double> coordinates(3 * (size_t)numPoints);
+    vector<int> triangles(3 * (size_t)numFaces);
+    if(singlePrecision)
+    {
+        const float * values = reinterpret_cast<const float *>(data + coordinatesStart);
+        copy(values, values + coordinates.size(), coordinates.begin());
+    }
+    else
+    {
+        memcpy(coordinates.data(), data + coordinatesStart, coordinatesSize);
+    }
+    memcpy(triangles.data(), data + trianglesStart, trianglesSize);
+    for(size_t i = 0; i < triangles.size(); i += 3)
     {
-        for(int iFace=0; iFace < numFaces; iFace++)
+        if(!isValidFace(triangles[i], triangles[i + 1], triangles[i + 2], numPoints))
         {
-            getline(myTriFile, line);
-            delimiterPos_1 = line.find(" ", 0);
-            f0 = atoi(line.substr(0,delimiterPos_1).c_str()) -1;
-            delimiterPos_2 = line.find(" ", delimiterPos_1+1);
-            f1 = atoi(line.substr(delimiterPos_1+1,delimiterPos_2 - (delimiterPos_1 + 1)).c_str()) - 1;
-            f2 = atoi(line.substr(delimiterPos_2+1).c_str()) - 1;
+            return NULL;
+        }
+    }
 
-            surface->getVertex(f0)->addNewFace(iFace);
-            surface->getVertex(f1)->addNewFace(iFace);
-            surface->getVertex(f2)->addNewFace(iFace);
+    Adjacency * adjacency = NULL;
+    if(withAdjacency)
+    {
+        vector<int> neighbourOffsets(numPoints + 1), neighbours(header.numNeighbours);
+        vector<int> faceOffsets(numPoints + 1), faces(header.numVertexFaces);
+        memcpy(neighbourOffsets.data(), data + neighbourOffsetsStart, offsetsSize);
+        memcpy(neighbours.data(), data + neighboursStart, neighboursSize);
+        memcpy(faceOffsets.data(), data + faceOffsetsStart, offsetsSize);
+        memcpy(faces.data(), data + facesStart, facesSize);
+        if(!isValidIndexArray(neighbourOffsets, neighbours, numPoints)
+                || !isValidIndexArray(faceOffsets, faces, numFaces))
+        {
+            return NULL;
+        }
+        adjacency = new Adjacency();
+        adjacency->setData(neighbourOffsets, neighbours, faceOffsets, faces);
+    }
 
-            Face  * faceVertex = new Face;
-            faceVertex->setPointsInFace(f0, f1, f2);
-            faceVertex->setFaceIndex(iFace);
-            surface->addNewFace(faceVertex);
+    vector<int> sourceFaces;
+    if(withSourceFaces)
+    {
+        sourceFaces.resize(numFaces);
+        memcpy(sourceFaces.data(), data + sourceFacesStart, numFaces * sizeof(int));
+        for(int i = 0; i < numFaces; i++)
+        {
+            if(sourceFaces[i] < 0 || (i > 0 && sourceFaces[i] < sourceFaces[i - 1]))
+            {
+                delete adjacency;
+                return NULL;
+            }
         }
-        myTriFile.close();
     }
-    else
+
+    Mesh * surface = new Mesh();
+    surface->setData(coordinates, triangles);
+    surface->setSourceFaces(sourceFaces);
+    surface->setAdjacency(adjacency);
+    if(header.flags & MESH_CACHE_BOUNDING_BOX)
     {
-        return NULL;
+        surface->setBoundingBox(header.boundingBox, header.boundingBox + 3);
     }
     return surface;
 }
+
+/**
+ * @brief isValidIndexArray Checks an array of the adjacency read from a cache,
+ *  so that a damaged file can not make the Engine read out of the mesh
+ * @param offsets Offsets of the values of every vertex, plus the total
+ * @param values Flat array with the values of all the vertexes
+ * @param numValues Values must be between 0 and numValues - 1
+ * @return true if the offsets are increasing and cover the whole array and
+ *  every value is in range
+ */
+bool FileManager::isValidIndexArray(const vector<int> & offsets, const vector<int> & values, int numValues)
+{
+    if(offsets.front() != 0 || offsets.back() != int(values.size()))
+    {
+        return false;
+    }
+    for(size_t i = 1; i < offsets.size(); i++)
+    {
+        if(offsets[i] < offsets[i - 1])
+        {
+            return false;
+        }
+    }
+    for(size_t i = 0; i < values.size(); i++)
+    {
+        if(values[i] < 0 || values[i] >= numValues)
+        {
+            return false;
+        }
+    }
+    return true;
+}
@@ -1,13 +1,307 @@
 #ifndef FILEMANAGER_H
 #define FILEMANAGER_H
 #include "../BasicStructures/mesh.h"
+#include "../Engine/jobcontrol.h"
+#include "compressedstream.h"
+#include "mappedfile.h"
+#include "meshcache.h"
+#include "plyheader.h"
+#include "textparser.h"
+#include "triangulator.h"
+#include "vertexwelder.h"
 #include <QFile>
 #include <QString>
+#include <QStringList>
 #include <fstream>
+#include <functional>
+#include <limits>
 #include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief MeshType Formats of the mesh files. TRIVERT meshes are read from a TRI
+ *  and a VERT file, the other ones from a single file.
+ */
+enum MeshType {TRIVERT, OFF, PLY, STL};
 
 class FileManager
 {
+private:
+    int numThreads;
+    JobControl * control;
+
+    /**
+     * @brief startProgress Starts a stage of the job control, if any, with the
+     *  total size of the files that are going to be read
+     * @param fileNames Names of the files
+     */
+    void startProgress(const QStringList & fileNames);
+
+    /**
+     * @brief addProgress Reports to the job control, if any, that some bytes of
+     *  the files have been read
+     * @param numBytes Number of bytes read since the last report
+     * @return false if the job has been cancelled
+     */
+    bool addProgress(qint64 numBytes);
+
+    /**
+     * @brief isValidFace Checks that the vertexes of a face exist in the mesh
+     * @param f0 Index of the first vertex of the face
+     * @param f1 Index of the second vertex of the face
+     * @param f2 Index of the third vertex of the face
+     * @param numPoints Number of vertexes of the mesh
+     * @return true if the three indexes are between 0 and numPoints - 1
+     */
+    bool isValidFace(int f0, int f1, int f2, int numPoints);
+
+    /**
+     * @brief parseOFFHeader Parse the first line of an OFF file
+     * @param parser Parser at the beginning of the file, left at the first point
+     * @param numPoints Receives the number of points of the file
+     * @param numFaces Receives the number of faces of the file
+     * @return false if the content is not a valid OFF file
+     */
+    bool parseOFFHeader(TextParser & parser, int & numPoints, int & numFaces);
+
+    /**
+     * @brief parseOFFBlock Parse a block of whole lines of an OFF file after its
+     *  header. The file has one point per line followed by one face per line.
+     *  Faces with more than 3 corners are split in triangles.
+     * @param begin Pointer to the first character of the block
+     * @param end Pointer past the last character of the block
+     * @param numPoints Number of points of the file
+     * @param numFaces Number of faces of the file
+     * @param numLinesRead Number of data lines read in the previous blocks, updated
+     * @param coordinates Array of 3 * numPoints elements that receives the points
+     * @param triangles Array where the indexes of the triangles are appended
+     * @param sourceFaces Array where the face every triangle comes from is appended
+     * @return true if every point and face could be read
+     */
+    bool parseOFFBlock(const char * begin, const char * end, int numPoints, int numFaces,
+                       int & numLinesRead, double * coordinates,
+                       vector<int> & triangles, vector<int> & sourceFaces);
+
+    /**
+     * @brief readBlocks Reads a text file as blocks of whole lines. A plain file is
+     *  mapped in memory and given as a single block, or as blocks of
+     *  progressBlockSize bytes when there is a job control. A compressed file is
+     *  decompressed on a second thread, and every block is parsed while the next
+     *  ones are decompressed, keeping only a few of them in memory. The bytes of
+     *  the file read are reported to the job control after every block.
+     * @param fileName Path of the file
+     * @param parseBlock Function called with the limits of every block, in order.
+     *  It returns false to stop reading.
+     * @return true if the whole file was read and every block was parsed, false
+     *  also if the job was cancelled
+     */
+    bool readBlocks(const QString & fileName,
+                    const function<bool(const char *, const char *)> & parseBlock);
+
+    /**
+     * @brief parseVert Parse a block of whole lines of a VERT file, one X Y Z
+     *  point per line
+     * @param begin Pointer to the first character of the block
+     * @param end Pointer past the last character of the block
+     * @param numThreads Number of threads used to parse the block
+     * @param coordinates Array where the coordinates of the points are appended
+     * @return true if every line contains a valid point
+     */
+    bool parseVert(const char * begin, const char * end, int numThreads, vector<double> & coordinates);
+
+    /**
+     * @brief parseTri Parse a block of whole lines of a TRI file, one face per
+     *  line with the indexes of its 3 points starting from 1
+     * @param begin Pointer to the first character of the block
+     * @param end Pointer past the last character of the block
+     * @param numThreads Number of threads used to parse the block
+     * @param triangles Array where the indexes of the faces are appended, starting from 0
+     * @return true if every line contains a valid face
+     */
+    bool parseTri(const char * begin, const char * end, int numThreads, vector<int> & triangles);
+
+    /**
+     * @brief splitInChunks Splits a text in pieces that can be parsed independently.
+     *  Every piece starts at the beginning of a line and ends after a '\n', except
+     *  the last one which ends with the text.
+     * @param begin Pointer to the first character of the text
+     * @param end Pointer past the last character of the text
+     * @param numThreads Number of threads that will parse the pieces
+     * @return The limits of the pieces, piece i is [chunks[i], chunks[i+1])
+     */
+    vector<const char *> splitInChunks(const char * begin, const char * end, int numThreads);
+
+    /**
+     * @brief countDataLines Counts the lines with data in every piece of a text,
+     *  that is the lines which are not blank or only a comment
+     * @param chunks The limits of the pieces, as returned by splitInChunks
+     * @param numThreads Number of threads used to count the lines
+     * @param linesBefore Number of data lines before the text, when it is a part of a file
+     * @return The number of data lines before every piece, the last element is
+     *  the total number of data lines
+     */
+    vector<int> countDataLines(const vector<const char *> & chunks, int numThreads, int linesBefore = 0);
+
+    /**
+     * @brief parseChunks Parses the data lines of every piece of a text in parallel.
+     *  The first numPoints data lines are points and the next numFaces data lines
+     *  are faces, every piece writes them directly in its position of the arrays.
+     * @param chunks The limits of the pieces, as returned by splitInChunks
+     * @param firstLines The number of data lines before every piece, as returned by countDataLines
+     * @param numPoints Number of data lines that are points
+     * @param numFaces Number of data lines that are faces, written as in TRI files
+     *  with the 3 indexes of the face starting from 1
+     * @param numThreads Number of threads used to parse the pieces
+     * @param coordinates Array of 3 * numPoints elements that receives the points
+     * @param triangles Array of 3 * numFaces elements that receives the faces
+     * @return true if every point and face could be read
+     */
+    bool parseChunks(const vector<const char *> & chunks, const vector<int> & firstLines,
+                     int numPoints, int numFaces, int numThreads,
+                     double * coordinates, int * triangles);
+
+    /**
+     * @brief parsePolygonChunks Parses the faces of an OFF file in parallel. Every
+     *  face is a data line with the number of corners followed by their indexes,
+     *  starting from 0. Polygons with more than 3 corners are triangulated, so
+     *  every piece fills its own arrays, which are then appended in order.
+     * @param chunks The limits of the pieces, as returned by splitInChunks
+     * @param firstLines The number of data lines before every piece, as returned by countDataLines
+     * @param numPoints Number of data lines that are points, before the faces
+     * @param numFaces Number of data lines that are faces
+     * @param numThreads Number of threads used to parse the pieces
+     * @param coordinates X Y Z coordinates of the points, already read
+     * @param triangles Array where the indexes of the triangles are appended
+     * @param sourceFaces Array where the face every triangle comes from is appended
+     * @return true if every face could be read and its indexes are valid
+     */
+    bool parsePolygonChunks(const vector<const char *> & chunks, const vector<int> & firstLines,
+                            int numPoints, int numFaces, int numThreads, const double * coordinates,
+                            vector<int> & triangles, vector<int> & sourceFaces);
+
+    /**
+     * @brief triangulatePolygons Splits polygonal faces in triangles
+     * @param coordinates X Y Z coordinates of the points
+     * @param numPoints Number of points
+     * @param polygonOffsets Corners of face i are polygonCorners[polygonOffsets[i]] ..
+     *  polygonCorners[polygonOffsets[i+1]-1]
+     * @param polygonCorners Flat array with the indexes of the corners of all the faces
+     * @param triangles Array that receives the indexes of the triangles
+     * @param sourceFaces Array that receives the face every triangle comes from
+     * @return true if every face has at least 3 corners and its indexes are valid
+     */
+    bool triangulatePolygons(const double * coordinates, int numPoints,
+                             const vector<int> & polygonOffsets, const vector<int> & polygonCorners,
+                             vector<int> & triangles, vector<int> & sourceFaces);
+
+    /**
+     * @brief buildPolygonalMesh Creates a mesh from triangulated faces, keeping the
+     *  face every triangle comes from only if some face was split
+     * @param coordinates X Y Z coordinates of the points, moved to the mesh
+     * @param triangles Indexes of the triangles, moved to the mesh
+     * @param sourceFaces Face every triangle comes from, moved to the mesh
+     * @param numFaces Number of faces in the file
+     * @return A pointer to an object of the Mesh class
+     */
+    Mesh * buildPolygonalMesh(vector<double> & coordinates, vector<int> & triangles,
+                              vector<int> & sourceFaces, int numFaces);
+
+    /**
+     * @brief parsePLY Parse the content of a PLY file. Only the x, y and z
+     *  properties of the vertexes and the vertex indexes of the faces are read,
+     *  other properties and elements are skipped. Faces with more than 3 corners
+     *  are split in triangles.
+     * @param begin Pointer to the first character of the file
+     * @param end Pointer past the last character of the file
+     * @return A pointer to an object of the Mesh class containing read faces and vertexes,
+     *  NULL if the content is not a valid PLY file
+     */
+    Mesh * parsePLY(const char * begin, const char * end);
+
+    /**
+     * @brief parsePLYAscii Parse the elements of an ASCII PLY file
+     * @param header The header of the file
+     * @param end Pointer past the last character of the file
+     * @param coordinateProperties Positions of the x, y and z properties in the vertex element
+     * @param indexesProperty Position of the vertex indexes list in the face element
+     * @param coordinates Array of 3 * number of vertexes elements that receives the points
+     * @param polygonOffsets Array of number of faces + 1 elements that receives the
+     *  offsets of the corners of every face
+     * @param polygonCorners Array where the indexes of the corners of the faces are appended
+     * @return true if every element could be read
+     */
+    bool parsePLYAscii(PlyHeader & header, const char * end, const int * coordinateProperties,
+                       int indexesProperty, double * coordinates,
+                       vector<int> & polygonOffsets, vector<int> & polygonCorners);
+
+    /**
+     * @brief parsePLYBinary Parse the elements of a binary PLY file. Vertexes have
+     *  a fixed size, so they are read in parallel, or copied at once when they
+     *  only contain x, y and z as doubles in the byte order of the machine.
+     * @param header The header of the file
+     * @param end Pointer past the last character of the file
+     * @param swapBytes true if the byte order of the file is not the one of the machine
+     * @param coordinateProperties Positions of the x, y and z properties in the vertex element
+     * @param indexesProperty Position of the vertex indexes list in the face element
+     * @param coordinates Array of 3 * number of vertexes elements that receives the points
+     * @param polygonOffsets Array of number of faces + 1 elements that receives the
+     *  offsets of the corners of every face
+     * @param polygonCorners Array where the indexes of the corners of the faces are appended
+     * @return true if every element could be read
+     */
+    bool parsePLYBinary(PlyHeader & header, const char * end, bool swapBytes,
+                        const int * coordinateProperties, int indexesProperty,
+                        double * coordinates, vector<int> & polygonOffsets,
+                        vector<int> & polygonCorners);
+
+    /**
+     * @brief parseSTL Parse the content of an STL file. Triangles that become
+     *  degenerate after welding their corners are dropped.
+     * @param begin Pointer to the first character of the file
+     * @param end Pointer past the last character of the file
+     * @param weldTolerance Corners whose coordinates round to the same multiple of
+     *  it are merged. With 0 only identical corners are merged.
+     * @return A pointer to an object of the Mesh class containing read faces and vertexes,
+     *  NULL if the content is not a valid STL file
+     */
+    Mesh * parseSTL(const char * begin, const char * end, double weldTolerance);
+
+    /**
+     * @brief addWeldedTriangle Adds a triangle whose corners have been welded,
+     *  unless two of them became the same vertex
+     * @param corners Indexes of the 3 welded vertexes of the triangle
+     * @param triangles Array where the triangle is appended
+     */
+    void addWeldedTriangle(const int * corners, vector<int> & triangles);
+
+    /**
+     * @brief buildWeldedMesh Creates a mesh with the vertexes of a welder
+     * @param welder The welder with the vertexes, its coordinates are moved to the mesh
+     * @param triangles Indexes of the faces, moved to the mesh
+     * @return A pointer to an object of the Mesh class
+     */
+    Mesh * buildWeldedMesh(VertexWelder & welder, vector<int> & triangles);
+
+    /**
+     * @brief readSourceSignature Gets the size and modification time of the source files of a cache
+     * @param sourceFileNames Names of up to 2 source files
+     * @param header Header whose sourceSizes and sourceModified are filled
+     * @return false if there are more than 2 source files or one of them does not exist
+     */
+    bool readSourceSignature(const QStringList & sourceFileNames, MeshCacheHeader & header);
+
+    /**
+     * @brief isValidIndexArray Checks an array of the adjacency read from a cache,
+     *  so that a damaged file can not make the Engine read out of the mesh
+     * @param offsets Offsets of the values of every vertex, plus the total
+     * @param values Flat array with the values of all the vertexes
+     * @param numValues Values must be between 0 and numValues - 1
+     * @return true if the offsets are increasing and cover the whole array and
+     *  every value is in range
+     */
+    bool isValidIndexArray(const vector<int> & offsets, const vector<int> & values, int numValues);
+
 public:
     /**
      * @brief FileManager Constructor for FileManager
@@ -15,19 +309,144 @@ public:
     FileManager();
 
     /**
-     * @brief readOFF Read an OFF file
+     * @brief setNumThreads defines the number of threads used to parse the files.
+     *  The mesh read does not depend on it.
+     * @param numThreads number of threads, 0 or less uses all the hardware threads
+     */
+    void setNumThreads(int numThreads);
+
+    /**
+     * @brief getNumThreads
+     * @return the number of threads used to parse the files
+     */
+    int getNumThreads();
+
+    /**
+     * @brief setJobControl defines the control that receives the progress of the
+     *  next files read, as a number of bytes, and that can cancel them. A read
+     *  that is cancelled returns NULL.
+     * @param control the control of the job, NULL to read without one
+     */
+    void setJobControl(JobControl * control);
+
+    /**
+     * @brief isCancelled
+     * @return true if the job control has been cancelled, which makes the
+     *  reads return NULL
+     */
+    bool isCancelled();
+
+    /**
+     * @brief readOFF Read an OFF file. Files compressed with gzip (.off.gz) are
+     *  decompressed on a second thread while they are parsed.
      * @param offFile Pointer to QFile for the OFF file selected from the GUI
      * @return A pointer to an object of the Mesh class containing read faces and vertexes
      */
     Mesh * readOFF(QFile * offFile);
 
     /**
-     * @brief readTriVert Read Tri and Vert files
+     * @brief readTriVert Read Tri and Vert files. Files compressed with gzip
+     *  (.tri.gz, .vert.gz) are decompressed on a second thread while they are parsed.
      * @param triFile Poitner to QFile specifying the TRI file selected from the GUI
      * @param vertFile Pointer to QFile specifying the VERT file selected from the GUI
      * @return A pointer to an object of the Mesh class containing faces and vertexes
      */
     Mesh * readTriVert(QFile * triFile, QFile * vertFile);
+
+    /**
+     * @brief readPLY Read a PLY file, in ASCII or binary format
+     * @param plyFile Pointer to QFile for the PLY file selected from the GUI
+     * @return A pointer to an object of the Mesh class containing read faces and vertexes
+     */
+    Mesh * readPLY(QFile * plyFile);
+
+    /**
+     * @brief readSTL Read an STL file, in binary or ASCII format. STL stores the
+     *  three corners of every triangle separately, so coincident corners are
+     *  welded into shared vertexes.
+     * @param stlFile Pointer to QFile for the STL file selected from the GUI
+     * @param weldTolerance Corners whose coordinates round to the same multiple of
+     *  it are merged. With 0 only identical corners are merged.
+     * @return A pointer to an object of the Mesh class containing read faces and vertexes
+     */
+    Mesh * readSTL(QFile * stlFile, double weldTolerance = 0.0);
+
+    /**
+     * @brief writePLY Write a mesh to a PLY file. Vertexes are written as doubles
+     *  and faces as lists of ints.
+     * @param mesh The mesh to write
+     * @param plyFile Pointer to QFile for the PLY file to write
+     * @param binary true to write the data in binary with the byte order of the
+     *  machine, false to write it as text
+     * @return true if the file could be written
+     */
+    bool writePLY(Mesh * mesh, QFile * plyFile, bool binary = true);
+
+    /**
+     * @brief getCacheFileName Name of the binary cache of a mesh file
+     * @param sourceFileName Name of the OFF file, or of the VERT file for TRI and VERT meshes
+     * @return The name of the cache file, next to the source file
+     */
+    static QString getCacheFileName(const QString & sourceFileName);
+
+    /**
+     * @brief detectMeshType Finds the format of a mesh file from its extension,
+     *  after removing the one of the compression. The extensions are lower case,
+     *  as the readers require, and only OFF, TRI and VERT files may be compressed.
+     * @param fileName Path of the file. For TRI and VERT meshes, either of them.
+     * @param type Receives the format
+     * @param file1 Receives the first file to read, the TRI file for TRIVERT meshes
+     * @param file2 Receives the VERT file for TRIVERT meshes, next to the TRI file
+     *  and with the same base name, and an empty string otherwise
+     * @return false if the extension is not one of a mesh file
+     */
+    static bool detectMeshType(const QString & fileName, MeshType & type, QString & file1, QString & file2);
+
+    /**
+     * @brief getSourceFiles Files a mesh is read from, the first one names its binary cache
+     * @param type The format of the mesh files
+     * @param file1 The first file, the TRI file for TRIVERT meshes
+     * @param file2 The VERT file for TRIVERT meshes
+     * @return The VERT and TRI files for TRIVERT meshes, file1 otherwise
+     */
+    static QStringList getSourceFiles(MeshType type, const QString & file1, const QString & file2);
+
+    /**
+     * @brief readMesh Reads a mesh from its binary cache, if it is valid, or
+     *  from its files with the reader of its format. The cache is not written,
+     *  which callers do with writeMeshCache when they choose to.
+     * @param type The format of the mesh files
+     * @param file1 The first file, the TRI file for TRIVERT meshes
+     * @param file2 The VERT file for TRIVERT meshes
+     * @param useCache false to always parse the files
+     * @param fromCache Receives true if the mesh was read from its cache, it may be NULL
+     * @return A pointer to an object of the Mesh class, NULL if the files could
+     *  not be read or the read was cancelled
+     */
+    Mesh * readMesh(MeshType type, const QString & file1, const QString & file2,
+                    bool useCache = true, bool * fromCache = NULL);
+
+    /**
+     * @brief writeMeshCache Writes a mesh in the binary cache format. The file is
+     *  replaced only once it has been completely written.
+     * @param mesh The mesh to write, its adjacency is built if it was not already
+     * @param cacheFileName Name of the cache file
+     * @param sourceFileNames Names of the files the mesh was read from, up to 2
+     * @param singlePrecision true to store the coordinates as float instead of double
+     * @return true if the file could be written
+     */
+    bool writeMeshCache(Mesh * mesh, const QString & cacheFileName,
+                        const QStringList & sourceFileNames, bool singlePrecision = false);
+
+    /**
+     * @brief readMeshCache Reads a mesh from a binary cache file. The file is
+     *  mapped in memory and its sections are copied directly into the mesh.
+     * @param cacheFileName Name of the cache file
+     * @param sourceFileNames Names of the files the mesh was read from, up to 2
+     * @return A pointer to an object of the Mesh class, NULL if the file does not
+     *  exist, is not valid or does not correspond to the current source files
+     */
+    Mesh * readMeshCache(const QString & cacheFileName, const QStringList & sourceFileNames);
 };
 
 #endif // FILEMANAGER_H
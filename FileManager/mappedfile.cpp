@@ -0,0 +1,81 @@
+#include "mappedfile.h"
+
+/**
+ * @brief MappedFile::MappedFile opens and maps a file
+ * @param fileName path of the file
+ */
+MappedFile::MappedFile(const QString & fileName) : file(fileName)
+{
+    mapped = NULL;
+    data = NULL;
+    length = 0;
+
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        return;
+    }
+    length = file.size();
+    if (length > 0)
+    {
+        mapped = file.map(0, length);
+    }
+    if (mapped != NULL)
+    {
+        data = reinterpret_cast<const char *>(mapped);
+    }
+    else
+    {
+        // Some devices can not be mapped, read them instead
+        contents = file.readAll();
+        data = contents.constData();
+        length = contents.size();
+    }
+}
+
+/**
+ * @brief MappedFile::~MappedFile unmaps and closes the file
+ */
+MappedFile::~MappedFile()
+{
+    if (mapped != NULL)
+    {
+        file.unmap(mapped);
+    }
+    file.close();
+}
+
+/**
+ * @brief MappedFile::isOpen
+ * @return true if the file could be opened
+ */
+bool MappedFile::isOpen()
+{
+    return file.isOpen();
+}
+
+/**
+ * @brief MappedFile::begin
+ * @return a pointer to the first byte of the file
+ */
+const char * MappedFile::begin()
+{
+    return data;
+}
+
+/**
+ * @brief MappedFile::end
+ * @return a pointer past the last byte of the file
+ */
+const char * MappedFile::end()
+{
+    return data + length;
+}
+
+/**
+ * @brief MappedFile::size
+ * @return the size of the file in bytes
+ */
+qint64 MappedFile::size()
+{
+    return length;
+}
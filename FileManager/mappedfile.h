@@ -0,0 +1,58 @@
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <QByteArray>
+#include <QFile>
+
+/**
+ * @brief The MappedFile class gives read access to the whole content of a file
+ *  as a contiguous block of memory. The file is memory-mapped when the system
+ *  allows it, otherwise it is read into memory.
+ */
+class MappedFile
+{
+private:
+    QFile file;
+    uchar * mapped;
+    QByteArray contents;
+    const char * data;
+    qint64 length;
+
+public:
+    /**
+     * @brief MappedFile opens and maps a file
+     * @param fileName path of the file
+     */
+    MappedFile(const QString & fileName);
+
+    /**
+     * @brief ~MappedFile unmaps and closes the file
+     */
+    ~MappedFile();
+
+    /**
+     * @brief isOpen
+     * @return true if the file could be opened
+     */
+    bool isOpen();
+
+    /**
+     * @brief begin
+     * @return a pointer to the first byte of the file
+     */
+    const char * begin();
+
+    /**
+     * @brief end
+     * @return a pointer past the last byte of the file
+     */
+    const char * end();
+
+    /**
+     * @brief size
+     * @return the size of the file in bytes
+     */
+    qint64 size();
+};
+
+#endif // MAPPEDFILE_H
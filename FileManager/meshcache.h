@@ -0,0 +1,74 @@
+#ifndef MESHCACHE_H
+#define MESHCACHE_H
+
+#include <QtGlobal>
+
+/**
+ * Binary mesh cache file (.hmc) written by FileManager next to a mesh read
+ * from text files, so that later sessions can load it without parsing.
+ *
+ * The file starts with a MeshCacheHeader followed by these sections, each one
+ * starting at a multiple of 8 bytes:
+ *  - coordinates: X Y Z of every vertex, as double, or as float if the
+ *    MESH_CACHE_SINGLE_PRECISION flag is set
+ *  - triangles: 3 quint32 vertex indexes per face
+ *  - only with MESH_CACHE_ADJACENCY: neighbour offsets (numVertexes + 1
+ *    quint32), neighbours (numNeighbours quint32), face offsets
+ *    (numVertexes + 1 quint32) and faces (numVertexFaces quint32)
+ *  - only with MESH_CACHE_SOURCE_FACES: the face of the source file every
+ *    triangle comes from (numFaces quint32)
+ *
+ * All the values are stored in the byte order of the machine that wrote the
+ * file; a file written with a different byte order is simply not used.
+ */
+
+/**
+ * @brief MESH_CACHE_MAGIC first 8 bytes of every cache file
+ */
+static const char MESH_CACHE_MAGIC[8] = {'H', 'I', 'P', 'M', 'E', 'S', 'H', '\0'};
+
+/**
+ * @brief MESH_CACHE_VERSION version of the layout, files with another one are ignored
+ */
+static const quint32 MESH_CACHE_VERSION = 2;
+
+/**
+ * @brief MESH_CACHE_BYTE_ORDER written as a quint32 to detect the byte order of the file
+ */
+static const quint32 MESH_CACHE_BYTE_ORDER = 0x01020304;
+
+/**
+ * @brief Flags of MeshCacheHeader::flags
+ */
+enum MeshCacheFlags
+{
+    MESH_CACHE_SINGLE_PRECISION = 1,
+    MESH_CACHE_ADJACENCY = 2,
+    MESH_CACHE_BOUNDING_BOX = 4,
+    MESH_CACHE_SOURCE_FACES = 8
+};
+
+/**
+ * @brief The MeshCacheHeader struct is the first block of a cache file. The
+ *  size and modification time of up to two source files are kept to detect
+ *  when the cache no longer corresponds to them.
+ */
+struct MeshCacheHeader
+{
+    char magic[8];
+    quint32 version;
+    quint32 flags;
+    quint32 byteOrder;
+    quint32 reserved;
+    quint32 numVertexes;
+    quint32 numFaces;
+    quint64 numNeighbours;
+    quint64 numVertexFaces;
+    quint64 sourceSizes[2];
+    qint64 sourceModified[2];
+    double boundingBox[6];
+};
+
+static_assert(sizeof(MeshCacheHeader) == 128, "The cache header must not depend on the compiler");
+
+#endif // MESHCACHE_H
@@ -0,0 +1,357 @@
+#include "plyheader.h"
+#include <algorithm>
+#include <cctype>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <QtGlobal>
+
+/**
+ * @brief bytesAs reinterprets the bytes of a value without breaking aliasing rules
+ */
+template <typename T>
+static inline double bytesAs(const char * bytes)
+{
+    T value;
+    memcpy(&value, bytes, sizeof(T));
+    return double(value);
+}
+
+/**
+ * @brief PlyHeader::PlyHeader creates an empty header
+ */
+PlyHeader::PlyHeader()
+{
+    format = PLY_ASCII;
+    dataStart = NULL;
+}
+
+/**
+ * @brief PlyHeader::parse reads the header at the beginning of a PLY file
+ * @param begin first character of the file
+ * @param end character after the file
+ * @return false if the file does not start with a valid PLY header
+ */
+bool PlyHeader::parse(const char * begin, const char * end)
+{
+    elements.clear();
+    bool hasFormat = false;
+    bool firstLine = true;
+
+    for(const char * line = begin; line < end; )
+    {
+        const char * lineEnd = static_cast<const char *>(memchr(line, '\n', end - line));
+        lineEnd = (lineEnd == NULL)? end : lineEnd;
+
+        //Header lines are split in words, '#' is not a comment in PLY
+        vector<string> words;
+        const char * position = line;
+        while(position < lineEnd)
+        {
+            while(position < lineEnd && isspace((unsigned char)*position))
+            {
+                position++;
+            }
+            const char * wordBegin = position;
+            while(position < lineEnd && !isspace((unsigned char)*position))
+            {
+                position++;
+            }
+            if(position > wordBegin)
+            {
+                words.push_back(string(wordBegin, position));
+            }
+        }
+        line = (lineEnd < end)? lineEnd + 1 : end;
+
+        if(firstLine)
+        {
+            if(words.size() != 1 || words[0] != "ply")
+            {
+                return false;
+            }
+            firstLine = false;
+        }
+        else if(words.empty() || words[0] == "comment" || words[0] == "obj_info")
+        {
+            continue;
+        }
+        else if(words[0] == "format" && words.size() == 3)
+        {
+            if(words[1] == "ascii")
+            {
+                format = PLY_ASCII;
+            }
+            else if(words[1] == "binary_little_endian")
+            {
+                format = PLY_BINARY_LITTLE_ENDIAN;
+            }
+            else if(words[1] == "binary_big_endian")
+            {
+                format = PLY_BINARY_BIG_ENDIAN;
+            }
+            else
+            {
+                return false;
+            }
+            hasFormat = true;
+        }
+        else if(words[0] == "element" && words.size() == 3)
+        {
+            PlyElement element;
+            element.name = words[1];
+            //Counts out of the range of int are rejected instead of wrapping
+            char * countEnd = NULL;
+            long long count = strtoll(words[2].c_str(), &countEnd, 10);
+            if(countEnd == words[2].c_str() || *countEnd != '\0' || count < 0 || count > INT_MAX)
+            {
+                return false;
+            }
+            element.count = int(count);
+            elements.push_back(element);
+        }
+        else if(words[0] == "property" && !elements.empty())
+        {
+            PlyProperty property;
+            property.isList = (words.size() == 5 && words[1] == "list");
+            property.countType = PLY_UINT8;
+            if(property.isList)
+            {
+                if(!parseType(words[2], property.countType) || !parseType(words[3], property.type))
+                {
+                    return false;
+                }
+                property.name = words[4];
+            }
+            else if(words.size() == 3 && parseType(words[1], property.type))
+            {
+                property.name = words[2];
+            }
+            else
+            {
+                return false;
+            }
+            elements.back().properties.push_back(property);
+        }
+        else if(words[0] == "end_header")
+        {
+            dataStart = line;
+            return hasFormat;
+        }
+        else
+        {
+            return false;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief PlyHeader::parseType converts the name of a PLY type
+ * @param name the name of the type, e.g. "float" or "float32"
+ * @param type the type
+ * @return false if the name is not a PLY type
+ */
+bool PlyHeader::parseType(const string & name, PlyType & type)
+{
+    if(name == "char" || name == "int8")
+    {
+        type = PLY_INT8;
+    }
+    else if(name == "uchar" || name == "uint8")
+    {
+        type = PLY_UINT8;
+    }
+    else if(name == "short" || name == "int16")
+    {
+        type = PLY_INT16;
+    }
+    else if(name == "ushort" || name == "uint16")
+    {
+        type = PLY_UINT16;
+    }
+    else if(name == "int" || name == "int32")
+    {
+        type = PLY_INT32;
+    }
+    else if(name == "uint" || name == "uint32")
+    {
+        type = PLY_UINT32;
+    }
+    else if(name == "float" || name == "float32")
+    {
+        type = PLY_FLOAT32;
+    }
+    else if(name == "double" || name == "float64")
+    {
+        type = PLY_FLOAT64;
+    }
+    else
+    {
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief PlyHeader::getFormat
+ * @return the encoding of the data of the file
+ */
+PlyFormat PlyHeader::getFormat()
+{
+    return format;
+}
+
+/**
+ * @brief PlyHeader::getElements
+ * @return the elements of the file, in the order their data is stored
+ */
+const vector<PlyElement> & PlyHeader::getElements()
+{
+    return elements;
+}
+
+/**
+ * @brief PlyHeader::getDataStart
+ * @return a pointer to the first character after the header
+ */
+const char * PlyHeader::getDataStart()
+{
+    return dataStart;
+}
+
+/**
+ * @brief PlyHeader::findProperty looks for a property of an element by name
+ * @param element the element
+ * @param name the name of the property
+ * @return the position of the property in the element, -1 if it does not exist
+ */
+int PlyHeader::findProperty(const PlyElement & element, const string & name)
+{
+    for(unsigned int i = 0; i < element.properties.size(); i++)
+    {
+        if(element.properties[i].name == name)
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief PlyHeader::getTypeSize
+ * @param type a PLY type
+ * @return the number of bytes of a value of the type in binary files
+ */
+int PlyHeader::getTypeSize(PlyType type)
+{
+    switch(type)
+    {
+    case PLY_INT8:
+    case PLY_UINT8:
+        return 1;
+    case PLY_INT16:
+    case PLY_UINT16:
+        return 2;
+    case PLY_INT32:
+    case PLY_UINT32:
+    case PLY_FLOAT32:
+        return 4;
+    case PLY_FLOAT64:
+        return 8;
+    }
+    return 0;
+}
+
+/**
+ * @brief PlyHeader::getFixedSize computes the number of bytes of every item
+ *  of an element in binary files
+ * @param element the element
+ * @return the size of an item, -1 if the element has list properties and the
+ *  size of its items varies
+ */
+int PlyHeader::getFixedSize(const PlyElement & element)
+{
+    int size = 0;
+    for(unsigned int i = 0; i < element.properties.size(); i++)
+    {
+        if(element.properties[i].isList)
+        {
+            return -1;
+        }
+        size += getTypeSize(element.properties[i].type);
+    }
+    return size;
+}
+
+/**
+ * @brief PlyHeader::getMinimumItemSize computes the fewest bytes an item of
+ *  an element can take in the file: the size of its values in binary files,
+ *  and 2 characters per value, a digit and a separator, in ASCII files
+ * @param element the element
+ * @param listProperty position of a list property with a minimum length, -1 if none
+ * @param minListValues fewest values of that list, the others may be empty
+ * @return the size of the smallest item
+ */
+long long PlyHeader::getMinimumItemSize(const PlyElement & element, int listProperty, int minListValues)
+{
+    long long size = 0;
+    for(unsigned int i = 0; i < element.properties.size(); i++)
+    {
+        const PlyProperty & property = element.properties[i];
+        int numValues = (property.isList && int(i) == listProperty)? minListValues : 0;
+        if(format == PLY_ASCII)
+        {
+            size += 2 * (property.isList? 1 + numValues : 1);
+        }
+        else if(property.isList)
+        {
+            size += getTypeSize(property.countType) + (long long)numValues * getTypeSize(property.type);
+        }
+        else
+        {
+            size += getTypeSize(property.type);
+        }
+    }
+    return size;
+}
+
+/**
+ * @brief PlyHeader::readValue reads a binary value of a PLY file
+ * @param data pointer to the value
+ * @param type type of the value
+ * @param swapBytes true if the byte order of the file is not the one of the machine
+ * @return the value converted to double
+ */
+double PlyHeader::readValue(const char * data, PlyType type, bool swapBytes)
+{
+    //Values are not aligned in PLY files, so they are copied before reading them
+    char bytes[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+    int size = getTypeSize(type);
+    memcpy(bytes, data, size);
+    if(swapBytes)
+    {
+        std::reverse(bytes, bytes + size);
+    }
+
+    switch(type)
+    {
+    case PLY_INT8:
+        return bytesAs<qint8>(bytes);
+    case PLY_UINT8:
+        return bytesAs<quint8>(bytes);
+    case PLY_INT16:
+        return bytesAs<qint16>(bytes);
+    case PLY_UINT16:
+        return bytesAs<quint16>(bytes);
+    case PLY_INT32:
+        return bytesAs<qint32>(bytes);
+    case PLY_UINT32:
+        return bytesAs<quint32>(bytes);
+    case PLY_FLOAT32:
+        return bytesAs<float>(bytes);
+    case PLY_FLOAT64:
+        return bytesAs<double>(bytes);
+    }
+    return 0.0;
+}
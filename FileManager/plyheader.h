@@ -0,0 +1,140 @@
+#ifndef PLYHEADER_H
+#define PLYHEADER_H
+
+#include <string>
+#include <vector>
+
+using std::string;
+using std::vector;
+
+/**
+ * @brief The PlyFormat enum lists the encodings of the data of a PLY file
+ */
+enum PlyFormat {PLY_ASCII, PLY_BINARY_LITTLE_ENDIAN, PLY_BINARY_BIG_ENDIAN};
+
+/**
+ * @brief The PlyType enum lists the scalar types of the PLY properties
+ */
+enum PlyType {PLY_INT8, PLY_UINT8, PLY_INT16, PLY_UINT16, PLY_INT32, PLY_UINT32, PLY_FLOAT32, PLY_FLOAT64};
+
+/**
+ * @brief The PlyProperty struct describes one property of a PLY element. List
+ *  properties store a count of type countType followed by that many values of
+ *  type type.
+ */
+struct PlyProperty
+{
+    string name;
+    PlyType type;
+    bool isList;
+    PlyType countType;
+};
+
+/**
+ * @brief The PlyElement struct describes one element of a PLY file, e.g. the
+ *  vertexes or the faces, with its properties in the order they are stored.
+ */
+struct PlyElement
+{
+    string name;
+    int count;
+    vector<PlyProperty> properties;
+};
+
+/**
+ * @brief The PlyHeader class reads the header of a PLY file: the format of the
+ *  data and the layout of every element.
+ */
+class PlyHeader
+{
+private:
+    PlyFormat format;
+    vector<PlyElement> elements;
+    const char * dataStart;
+
+    /**
+     * @brief parseType converts the name of a PLY type
+     * @param name the name of the type, e.g. "float" or "float32"
+     * @param type the type
+     * @return false if the name is not a PLY type
+     */
+    bool parseType(const string & name, PlyType & type);
+
+public:
+    /**
+     * @brief PlyHeader creates an empty header
+     */
+    PlyHeader();
+
+    /**
+     * @brief parse reads the header at the beginning of a PLY file
+     * @param begin first character of the file
+     * @param end character after the file
+     * @return false if the file does not start with a valid PLY header
+     */
+    bool parse(const char * begin, const char * end);
+
+    /**
+     * @brief getFormat
+     * @return the encoding of the data of the file
+     */
+    PlyFormat getFormat();
+
+    /**
+     * @brief getElements
+     * @return the elements of the file, in the order their data is stored
+     */
+    const vector<PlyElement> & getElements();
+
+    /**
+     * @brief getDataStart
+     * @return a pointer to the first character after the header
+     */
+    const char * getDataStart();
+
+    /**
+     * @brief findProperty looks for a property of an element by name
+     * @param element the element
+     * @param name the name of the property
+     * @return the position of the property in the element, -1 if it does not exist
+     */
+    static int findProperty(const PlyElement & element, const string & name);
+
+    /**
+     * @brief getTypeSize
+     * @param type a PLY type
+     * @return the number of bytes of a value of the type in binary files
+     */
+    static int getTypeSize(PlyType type);
+
+    /**
+     * @brief getFixedSize computes the number of bytes of every item of an
+     *  element in binary files
+     * @param element the element
+     * @return the size of an item, -1 if the element has list properties and
+     *  the size of its items varies
+     */
+    static int getFixedSize(const PlyElement & element);
+
+    /**
+     * @brief getMinimumItemSize computes the fewest bytes an item of an
+     *  element can take in the file: the size of its values in binary files,
+     *  and 2 characters per value, a digit and a separator, in ASCII files
+     * @param element the element
+     * @param listProperty position of a list property with a minimum length, -1 if none
+     * @param minListValues fewest values of that list, the others may be empty
+     * @return the size of the smallest item
+     */
+    long long getMinimumItemSize(const PlyElement & element, int listProperty, int minListValues);
+
+    /**
+     * @brief readValue reads a binary value of a PLY file
+     * @param data pointer to the value
+     * @param type type of the value
+     * @param swapBytes true if the byte order of the file is not the one of the machine
+     * @return the value converted to double
+     */
+    static double readValue(const char * data, PlyType type, bool swapBytes);
+};
+
+#endif // PLYHEADER_H
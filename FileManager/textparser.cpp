@@ -0,0 +1,312 @@
+#include "textparser.h"
+#include <cstdlib>
+#include <limits>
+#include <string>
+
+/**
+ * @brief isSpace checks if a character separates tokens
+ */
+static inline bool isSpace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v';
+}
+
+/**
+ * @brief isDigit checks if a character is a decimal digit
+ */
+static inline bool isDigit(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+/**
+ * @brief TextParser::TextParser creates a parser for the text in [begin, end)
+ * @param begin first character of the text
+ * @param end character after the text
+ */
+TextParser::TextParser(const char * begin, const char * end)
+{
+    current = begin;
+    last = end;
+}
+
+/**
+ * @brief TextParser::atEnd
+ * @return true if there is nothing left to read but spaces and comments
+ */
+bool TextParser::atEnd()
+{
+    skipSpacesAndComments();
+    return current >= last;
+}
+
+/**
+ * @brief TextParser::getPosition
+ * @return a pointer to the next character to read
+ */
+const char * TextParser::getPosition()
+{
+    return current;
+}
+
+/**
+ * @brief TextParser::skipSpacesAndComments moves to the beginning of the next token
+ */
+void TextParser::skipSpacesAndComments()
+{
+    while (current < last)
+    {
+        if (isSpace(*current))
+        {
+            current++;
+        }
+        else if (*current == '#')
+        {
+            skipLine();
+        }
+        else
+        {
+            return;
+        }
+    }
+}
+
+/**
+ * @brief TextParser::skipLine moves to the beginning of the next line,
+ *  ignoring the rest of the current one
+ */
+void TextParser::skipLine()
+{
+    while (current < last && *current != '\n')
+    {
+        current++;
+    }
+    if (current < last)
+    {
+        current++;
+    }
+}
+
+/**
+ * @brief TextParser::isEndOfLine checks if there are no more tokens in the
+ *  current line
+ * @return true if only spaces or a comment remain in the line
+ */
+bool TextParser::isEndOfLine()
+{
+    const char * position = current;
+    while (position < last && *position != '\n' && isSpace(*position))
+    {
+        position++;
+    }
+    return position >= last || *position == '\n' || *position == '#';
+}
+
+/**
+ * @brief TextParser::readWord reads the next token as a word
+ * @param wordBegin pointer to the first character of the word
+ * @param wordLength number of characters of the word
+ * @return false if there are no more tokens
+ */
+bool TextParser::readWord(const char * & wordBegin, int & wordLength)
+{
+    skipSpacesAndComments();
+    if (current >= last)
+    {
+        return false;
+    }
+    wordBegin = current;
+    while (current < last && !isSpace(*current) && *current != '#')
+    {
+        current++;
+    }
+    wordLength = current - wordBegin;
+    return true;
+}
+
+/**
+ * @brief TextParser::readInt reads the next token as an integer number
+ * @param value the number read
+ * @return false if the token is not an integer or there are no more tokens
+ */
+bool TextParser::readInt(int & value)
+{
+    skipSpacesAndComments();
+    const char * position = current;
+    bool negative = false;
+    if (position < last && (*position == '-' || *position == '+'))
+    {
+        negative = (*position == '-');
+        position++;
+    }
+    if (position >= last || !isDigit(*position))
+    {
+        return false;
+    }
+
+    long long number = 0;
+    while (position < last && isDigit(*position))
+    {
+        number = number * 10 + (*position - '0');
+        if (number > std::numeric_limits<int>::max())
+        {
+            return false;
+        }
+        position++;
+    }
+    if (position < last && !isSpace(*position) && *position != '#')
+    {
+        return false;
+    }
+
+    current = position;
+    value = int(negative? -number : number);
+    return true;
+}
+
+/**
+ * @brief TextParser::readDouble reads the next token as a real number.
+ *  Numbers with up to 15 significant digits and small exponents are converted
+ *  exactly without calling the C library.
+ * @param value the number read
+ * @return false if the token is not a number or there are no more tokens
+ */
+bool TextParser::readDouble(double & value)
+{
+    // Exact powers of ten: a double with at most 15 significant digits
+    // multiplied or divided by one of them is correctly rounded
+    static const double powersOfTen[] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10,
+        1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+    skipSpacesAndComments();
+    if (current >= last)
+    {
+        return false;
+    }
+    const char * tokenBegin = current;
+    const char * position = current;
+
+    bool negative = false;
+    if (*position == '-' || *position == '+')
+    {
+        negative = (*position == '-');
+        position++;
+    }
+
+    unsigned long long mantissa = 0;
+    int significantDigits = 0;
+    int exponent = 0;
+    bool hasDigits = false;
+
+    // Integer part
+    while (position < last && isDigit(*position))
+    {
+        hasDigits = true;
+        if (mantissa == 0 && *position == '0')
+        {
+            position++;
+            continue;
+        }
+        if (significantDigits < 19)
+        {
+            mantissa = mantissa * 10 + (*position - '0');
+        }
+        else
+        {
+            exponent++;
+        }
+        significantDigits++;
+        position++;
+    }
+    // Fractional part
+    if (position < last && *position == '.')
+    {
+        position++;
+        while (position < last && isDigit(*position))
+        {
+            hasDigits = true;
+            if (mantissa == 0 && *position == '0')
+            {
+                exponent--;
+                position++;
+                continue;
+            }
+            if (significantDigits < 19)
+            {
+                mantissa = mantissa * 10 + (*position - '0');
+                exponent--;
+            }
+            significantDigits++;
+            position++;
+        }
+    }
+    // Exponent part
+    if (hasDigits && position < last && (*position == 'e' || *position == 'E'))
+    {
+        const char * exponentBegin = position;
+        position++;
+        bool negativeExponent = false;
+        if (position < last && (*position == '-' || *position == '+'))
+        {
+            negativeExponent = (*position == '-');
+            position++;
+        }
+        if (position < last && isDigit(*position))
+        {
+            int explicitExponent = 0;
+            while (position < last && isDigit(*position))
+            {
+                if (explicitExponent < 100000)
+                {
+                    explicitExponent = explicitExponent * 10 + (*position - '0');
+                }
+                position++;
+            }
+            exponent += negativeExponent? -explicitExponent : explicitExponent;
+        }
+        else
+        {
+            position = exponentBegin;
+        }
+    }
+
+    bool tokenEnds = (position >= last || isSpace(*position) || *position == '#');
+    if (hasDigits && tokenEnds && significantDigits <= 15 && exponent >= -22 && exponent <= 22)
+    {
+        double number = double(mantissa);
+        number = (exponent < 0)? number / powersOfTen[-exponent] : number * powersOfTen[exponent];
+        value = negative? -number : number;
+        current = position;
+        return true;
+    }
+
+    // Long mantissas, large exponents, inf and nan go through strtod
+    const char * tokenEnd = tokenBegin;
+    while (tokenEnd < last && !isSpace(*tokenEnd) && *tokenEnd != '#')
+    {
+        tokenEnd++;
+    }
+    if (!parseDoubleSlow(tokenBegin, tokenEnd, value))
+    {
+        return false;
+    }
+    current = tokenEnd;
+    return true;
+}
+
+/**
+ * @brief TextParser::parseDoubleSlow converts a token that the fast path can
+ *  not convert exactly, using strtod on a null-terminated copy of it
+ * @param tokenBegin first character of the token
+ * @param tokenEnd character after the token
+ * @param value the converted number
+ * @return true if the whole token is a number
+ */
+bool TextParser::parseDoubleSlow(const char * tokenBegin, const char * tokenEnd, double & value)
+{
+    std::string token(tokenBegin, tokenEnd);
+    char * parsedEnd = NULL;
+    value = strtod(token.c_str(), &parsedEnd);
+    return !token.empty() && parsedEnd == token.c_str() + token.size();
+}
@@ -0,0 +1,88 @@
+#ifndef TEXTPARSER_H
+#define TEXTPARSER_H
+
+/**
+ * @brief The TextParser class reads numbers from a block of text in place,
+ *  without copying it into strings. Tokens are separated by any amount of
+ *  spaces, tabs or line breaks, and everything from a '#' to the end of the
+ *  line is a comment.
+ */
+class TextParser
+{
+private:
+    const char * current;
+    const char * last;
+
+    /**
+     * @brief parseDoubleSlow converts a token that the fast path can not
+     *  convert exactly, using strtod on a null-terminated copy of it
+     * @param tokenBegin first character of the token
+     * @param tokenEnd character after the token
+     * @param value the converted number
+     * @return true if the whole token is a number
+     */
+    bool parseDoubleSlow(const char * tokenBegin, const char * tokenEnd, double & value);
+
+public:
+    /**
+     * @brief TextParser creates a parser for the text in [begin, end)
+     * @param begin first character of the text
+     * @param end character after the text
+     */
+    TextParser(const char * begin, const char * end);
+
+    /**
+     * @brief atEnd
+     * @return true if there is nothing left to read but spaces and comments
+     */
+    bool atEnd();
+
+    /**
+     * @brief getPosition
+     * @return a pointer to the next character to read
+     */
+    const char * getPosition();
+
+    /**
+     * @brief skipSpacesAndComments moves to the beginning of the next token
+     */
+    void skipSpacesAndComments();
+
+    /**
+     * @brief skipLine moves to the beginning of the next line, ignoring the
+     *  rest of the current one
+     */
+    void skipLine();
+
+    /**
+     * @brief isEndOfLine checks if there are no more tokens in the current line
+     * @return true if only spaces or a comment remain in the line
+     */
+    bool isEndOfLine();
+
+    /**
+     * @brief readWord reads the next token as a word
+     * @param wordBegin pointer to the first character of the word
+     * @param wordLength number of characters of the word
+     * @return false if there are no more tokens
+     */
+    bool readWord(const char * & wordBegin, int & wordLength);
+
+    /**
+     * @brief readInt reads the next token as an integer number
+     * @param value the number read
+     * @return false if the token is not an integer or there are no more tokens
+     */
+    bool readInt(int & value);
+
+    /**
+     * @brief readDouble reads the next token as a real number. Numbers with
+     *  up to 15 significant digits and small exponents are converted exactly
+     *  without calling the C library.
+     * @param value the number read
+     * @return false if the token is not a number or there are no more tokens
+     */
+    bool readDouble(double & value);
+};
+
+#endif // TEXTPARSER_H
@@ -0,0 +1,162 @@
+#include "triangulator.h"
+#include <cmath>
+
+/**
+ * @brief Triangulator::Triangulator creates a triangulator for the faces of a mesh
+ * @param coordinates X Y Z coordinates of the vertexes of the mesh
+ */
+Triangulator::Triangulator(const double * coordinates)
+{
+    this->coordinates = coordinates;
+}
+
+/**
+ * @brief Triangulator::cross computes the z component of the cross product of
+ *  the projected edges a->b and a->c
+ * @param a position of the first corner in projected
+ * @param b position of the second corner in projected
+ * @param c position of the third corner in projected
+ * @return positive if a, b, c turn counter-clockwise
+ */
+double Triangulator::cross(int a, int b, int c)
+{
+    const double * pa = &projected[2 * a];
+    const double * pb = &projected[2 * b];
+    const double * pc = &projected[2 * c];
+    return (pb[0] - pa[0]) * (pc[1] - pa[1]) - (pb[1] - pa[1]) * (pc[0] - pa[0]);
+}
+
+/**
+ * @brief Triangulator::isEar checks if the triangle formed by a corner and its
+ *  neighbours in remaining can be cut from the polygon
+ * @param previous position of the previous corner in remaining
+ * @param current position of the corner in remaining
+ * @param next position of the next corner in remaining
+ * @return true if the corner is convex and no other corner lies inside the triangle
+ */
+bool Triangulator::isEar(int previous, int current, int next)
+{
+    int a = remaining[previous];
+    int b = remaining[current];
+    int c = remaining[next];
+    if(cross(a, b, c) <= 0)
+    {
+        return false;
+    }
+    for(unsigned int i = 0; i < remaining.size(); i++)
+    {
+        int p = remaining[i];
+        if(p == a || p == b || p == c)
+        {
+            continue;
+        }
+        if(cross(a, b, p) >= 0 && cross(b, c, p) >= 0 && cross(c, a, p) >= 0)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Triangulator::addPolygon splits a polygon in triangles
+ * @param corners indexes of the vertexes of the polygon, in order
+ * @param numCorners number of corners, at least 3
+ * @param sourceFace index of the polygon in the file, stored for every triangle
+ * @param triangles array where the 3 indexes of every triangle are appended
+ * @param sourceFaces array where sourceFace is appended once per triangle
+ */
+void Triangulator::addPolygon(const int * corners, int numCorners, int sourceFace,
+                              vector<int> & triangles, vector<int> & sourceFaces)
+{
+    if(numCorners == 3)
+    {
+        triangles.insert(triangles.end(), corners, corners + 3);
+        sourceFaces.push_back(sourceFace);
+        return;
+    }
+
+    // Newell normal of the polygon, valid for non planar polygons too
+    double normal[3] = {0.0, 0.0, 0.0};
+    for(int i = 0; i < numCorners; i++)
+    {
+        const double * current = coordinates + 3 * (size_t)corners[i];
+        const double * next = coordinates + 3 * (size_t)corners[(i + 1) % numCorners];
+        normal[0] += (current[1] - next[1]) * (current[2] + next[2]);
+        normal[1] += (current[2] - next[2]) * (current[0] + next[0]);
+        normal[2] += (current[0] - next[0]) * (current[1] + next[1]);
+    }
+
+    // Drop the dominant axis, swapping the other two if needed so that the
+    // projected polygon is counter-clockwise
+    int axis = 0;
+    for(int i = 1; i < 3; i++)
+    {
+        if(fabs(normal[i]) > fabs(normal[axis]))
+        {
+            axis = i;
+        }
+    }
+    int u = (axis + 1) % 3;
+    int v = (axis + 2) % 3;
+    if(normal[axis] < 0)
+    {
+        int swap = u;
+        u = v;
+        v = swap;
+    }
+    projected.resize(2 * numCorners);
+    for(int i = 0; i < numCorners; i++)
+    {
+        const double * point = coordinates + 3 * (size_t)corners[i];
+        projected[2 * i] = point[u];
+        projected[2 * i + 1] = point[v];
+    }
+
+    bool isConvex = (normal[axis] != 0);
+    for(int i = 0; i < numCorners && isConvex; i++)
+    {
+        isConvex = cross(i, (i + 1) % numCorners, (i + 2) % numCorners) >= 0;
+    }
+
+    remaining.resize(numCorners);
+    for(int i = 0; i < numCorners; i++)
+    {
+        remaining[i] = i;
+    }
+
+    // Ear clipping, cutting the first ear found on every pass
+    while(!isConvex && remaining.size() > 3)
+    {
+        int size = remaining.size();
+        bool earFound = false;
+        for(int i = 0; i < size && !earFound; i++)
+        {
+            int previous = (i + size - 1) % size;
+            int next = (i + 1) % size;
+            if(isEar(previous, i, next))
+            {
+                triangles.push_back(corners[remaining[previous]]);
+                triangles.push_back(corners[remaining[i]]);
+                triangles.push_back(corners[remaining[next]]);
+                sourceFaces.push_back(sourceFace);
+                remaining.erase(remaining.begin() + i);
+                earFound = true;
+            }
+        }
+        if(!earFound)
+        {
+            // Degenerate or self intersecting polygon, the rest is split as a fan
+            break;
+        }
+    }
+
+    // Fan from the first remaining corner
+    for(unsigned int i = 1; i + 1 < remaining.size(); i++)
+    {
+        triangles.push_back(corners[remaining[0]]);
+        triangles.push_back(corners[remaining[i]]);
+        triangles.push_back(corners[remaining[i + 1]]);
+        sourceFaces.push_back(sourceFace);
+    }
+}
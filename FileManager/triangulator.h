@@ -0,0 +1,61 @@
+#ifndef TRIANGULATOR_H
+#define TRIANGULATOR_H
+
+#include <vector>
+
+using std::vector;
+
+/**
+ * @brief The Triangulator class splits the polygonal faces of a mesh in
+ *  triangles. Polygons are projected on the plane orthogonal to the dominant
+ *  axis of their Newell normal; convex ones are split as a fan from their
+ *  first corner and the others by ear clipping. An object keeps scratch
+ *  buffers between calls, so every thread should use its own.
+ */
+class Triangulator
+{
+private:
+    const double * coordinates;
+    vector<double> projected;
+    vector<int> remaining;
+
+    /**
+     * @brief cross computes the z component of the cross product of the
+     *  projected edges a->b and a->c
+     * @param a position of the first corner in projected
+     * @param b position of the second corner in projected
+     * @param c position of the third corner in projected
+     * @return positive if a, b, c turn counter-clockwise
+     */
+    double cross(int a, int b, int c);
+
+    /**
+     * @brief isEar checks if the triangle formed by a corner and its neighbours
+     *  in remaining can be cut from the polygon
+     * @param previous position of the previous corner in remaining
+     * @param current position of the corner in remaining
+     * @param next position of the next corner in remaining
+     * @return true if the corner is convex and no other corner lies inside the triangle
+     */
+    bool isEar(int previous, int current, int next);
+
+public:
+    /**
+     * @brief Triangulator creates a triangulator for the faces of a mesh
+     * @param coordinates X Y Z coordinates of the vertexes of the mesh
+     */
+    Triangulator(const double * coordinates);
+
+    /**
+     * @brief addPolygon splits a polygon in triangles
+     * @param corners indexes of the vertexes of the polygon, in order
+     * @param numCorners number of corners, at least 3
+     * @param sourceFace index of the polygon in the file, stored for every triangle
+     * @param triangles array where the 3 indexes of every triangle are appended
+     * @param sourceFaces array where sourceFace is appended once per triangle
+     */
+    void addPolygon(const int * corners, int numCorners, int sourceFace,
+                    vector<int> & triangles, vector<int> & sourceFaces);
+};
+
+#endif // TRIANGULATOR_H
@@ -0,0 +1,148 @@
+#include "vertexwelder.h"
+#include <cmath>
+#include <cstring>
+
+/**
+ * @brief VertexWelder::VertexWelder creates an empty welder
+ * @param tolerance vertexes whose coordinates round to the same multiple of
+ *  tolerance are merged. With 0 only identical coordinates are merged.
+ * @param expectedVertexes expected number of vertexes after welding, to
+ *  allocate the table in advance
+ */
+VertexWelder::VertexWelder(double tolerance, int expectedVertexes)
+{
+    this->tolerance = (tolerance > 0)? tolerance : 0.0;
+    coordinates.reserve(3 * (size_t)expectedVertexes);
+    keys.reserve(expectedVertexes);
+
+    size_t numSlots = 16;
+    while(numSlots < 2 * (size_t)expectedVertexes)
+    {
+        numSlots *= 2;
+    }
+    table.assign(numSlots, -1);
+}
+
+/**
+ * @brief VertexWelder::makeKey quantises a position
+ * @param x coordinate in X
+ * @param y coordinate in Y
+ * @param z coordinate in Z
+ * @return the key of the position
+ */
+VertexWelder::WeldKey VertexWelder::makeKey(double x, double y, double z)
+{
+    WeldKey key;
+    if(tolerance > 0)
+    {
+        key.x = llround(x / tolerance);
+        key.y = llround(y / tolerance);
+        key.z = llround(z / tolerance);
+    }
+    else
+    {
+        // Adding 0.0 turns -0.0 into 0.0, so both get the same bits
+        double values[3] = {x + 0.0, y + 0.0, z + 0.0};
+        memcpy(&key.x, &values[0], sizeof(double));
+        memcpy(&key.y, &values[1], sizeof(double));
+        memcpy(&key.z, &values[2], sizeof(double));
+    }
+    return key;
+}
+
+/**
+ * @brief VertexWelder::hashKey mixes the bits of a key
+ * @param key the key
+ * @return the hash of the key
+ */
+unsigned long long VertexWelder::hashKey(const WeldKey & key)
+{
+    // splitmix64 finaliser over the three components
+    unsigned long long hash = 0x9E3779B97F4A7C15ULL;
+    const long long components[3] = {key.x, key.y, key.z};
+    for(int i = 0; i < 3; i++)
+    {
+        hash ^= (unsigned long long)components[i] + 0x9E3779B97F4A7C15ULL + (hash << 6) + (hash >> 2);
+        hash = (hash ^ (hash >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        hash = (hash ^ (hash >> 27)) * 0x94D049BB133111EBULL;
+        hash ^= hash >> 31;
+    }
+    return hash;
+}
+
+/**
+ * @brief VertexWelder::resizeTable allocates a larger table and inserts the vertexes again
+ * @param numSlots new number of slots, a power of 2
+ */
+void VertexWelder::resizeTable(size_t numSlots)
+{
+    table.assign(numSlots, -1);
+    size_t mask = numSlots - 1;
+    for(size_t vertex = 0; vertex < keys.size(); vertex++)
+    {
+        size_t slot = hashKey(keys[vertex]) & mask;
+        while(table[slot] >= 0)
+        {
+            slot = (slot + 1) & mask;
+        }
+        table[slot] = vertex;
+    }
+}
+
+/**
+ * @brief VertexWelder::addVertex looks for a vertex at a position, adding it
+ *  if it does not exist
+ * @param x coordinate in X
+ * @param y coordinate in Y
+ * @param z coordinate in Z
+ * @return the index of the vertex
+ */
+int VertexWelder::addVertex(double x, double y, double z)
+{
+    WeldKey key = makeKey(x, y, z);
+    size_t mask = table.size() - 1;
+    size_t slot = hashKey(key) & mask;
+
+    // Linear probing until the key or an empty slot is found
+    while(table[slot] >= 0)
+    {
+        const WeldKey & stored = keys[table[slot]];
+        if(stored.x == key.x && stored.y == key.y && stored.z == key.z)
+        {
+            return table[slot];
+        }
+        slot = (slot + 1) & mask;
+    }
+
+    int vertex = keys.size();
+    keys.push_back(key);
+    coordinates.push_back(x);
+    coordinates.push_back(y);
+    coordinates.push_back(z);
+    table[slot] = vertex;
+
+    if(2 * keys.size() > table.size())
+    {
+        resizeTable(2 * table.size());
+    }
+    return vertex;
+}
+
+/**
+ * @brief VertexWelder::getNumVertexes
+ * @return the number of different vertexes added
+ */
+int VertexWelder::getNumVertexes()
+{
+    return keys.size();
+}
+
+/**
+ * @brief VertexWelder::getCoordinates
+ * @return the X Y Z coordinates of the different vertexes, in the order they
+ *  were first added. The array can be swapped into a Mesh.
+ */
+vector<double> & VertexWelder::getCoordinates()
+{
+    return coordinates;
+}
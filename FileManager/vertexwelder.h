@@ -0,0 +1,93 @@
+#ifndef VERTEXWELDER_H
+#define VERTEXWELDER_H
+
+#include <cstddef>
+#include <vector>
+
+using std::vector;
+
+/**
+ * @brief The VertexWelder class merges coincident vertexes of formats that
+ *  store every triangle with its own copy of its corners, like STL. Vertexes
+ *  are looked up in an open-addressing hash table by their quantised
+ *  coordinates, so every distinct position gets a single index.
+ */
+class VertexWelder
+{
+private:
+    /**
+     * @brief The WeldKey struct is the quantised position of a vertex
+     */
+    struct WeldKey
+    {
+        long long x;
+        long long y;
+        long long z;
+    };
+
+    double tolerance;
+    vector<double> coordinates;
+    vector<WeldKey> keys;
+
+    /**
+     * @brief table: index of the vertex stored in every slot, -1 if empty. Its
+     *  size is a power of 2 and it is kept at most half full.
+     */
+    vector<int> table;
+
+    /**
+     * @brief makeKey quantises a position
+     * @param x coordinate in X
+     * @param y coordinate in Y
+     * @param z coordinate in Z
+     * @return the key of the position
+     */
+    WeldKey makeKey(double x, double y, double z);
+
+    /**
+     * @brief hashKey mixes the bits of a key
+     * @param key the key
+     * @return the hash of the key
+     */
+    static unsigned long long hashKey(const WeldKey & key);
+
+    /**
+     * @brief resizeTable allocates a larger table and inserts the vertexes again
+     * @param numSlots new number of slots, a power of 2
+     */
+    void resizeTable(std::size_t numSlots);
+
+public:
+    /**
+     * @brief VertexWelder creates an empty welder
+     * @param tolerance vertexes whose coordinates round to the same multiple of
+     *  tolerance are merged. With 0 only identical coordinates are merged.
+     * @param expectedVertexes expected number of vertexes after welding, to
+     *  allocate the table in advance
+     */
+    VertexWelder(double tolerance, int expectedVertexes);
+
+    /**
+     * @brief addVertex looks for a vertex at a position, adding it if it does not exist
+     * @param x coordinate in X
+     * @param y coordinate in Y
+     * @param z coordinate in Z
+     * @return the index of the vertex
+     */
+    int addVertex(double x, double y, double z);
+
+    /**
+     * @brief getNumVertexes
+     * @return the number of different vertexes added
+     */
+    int getNumVertexes();
+
+    /**
+     * @brief getCoordinates
+     * @return the X Y Z coordinates of the different vertexes, in the order
+     *  they were first added. The array can be swapped into a Mesh.
+     */
+    vector<double> & getCoordinates();
+};
+
+#endif // VERTEXWELDER_H
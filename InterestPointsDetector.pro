@@ -1,5 +1,5 @@
 QT += core gui widgets opengl
-CONFIG += c++11
+CONFIG += c++11 thread
 CONFIG -= app_bundle
 
 # The following define makes your compiler emit warnings if you use
@@ -13,17 +13,19 @@ DEFINES += QT_DEPRECATED_WARNINGS
 # You can also select to disable deprecated APIs only up to a certain version of Qt.
 #DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
 
+# BasicStructures, FileManager and Engine, shared with the benchmark
+include(core.pri)
+
 SOURCES += \
         main.cpp \
     UI/mainwindow.cpp \
-    BasicStructures/face.cpp \
-    BasicStructures/mesh.cpp \
-    BasicStructures/vertex.cpp \
+    Communicator/backgroundjob.cpp \
     Communicator/communicator.cpp \
     Communicator/exception.cpp \
-    FileManager/filemanager.cpp \
+    Communicator/interestpointsjob.cpp \
+    Communicator/meshloadingjob.cpp \
+    Communicator/resultcache.cpp \
     Render/openglwidget.cpp \
-    Engine/engine.cpp \
     Render/renderutil.cpp
 
 # Default rules for deployment.
@@ -33,14 +35,13 @@ else: unix:!android: target.path = /opt/$${TARGET}/bin
 
 HEADERS += \
     UI/mainwindow.h \
-    BasicStructures/face.h \
-    BasicStructures/mesh.h \
-    BasicStructures/vertex.h \
+    Communicator/backgroundjob.h \
     Communicator/communicator.h \
     Communicator/exception.h \
-    FileManager/filemanager.h \
+    Communicator/interestpointsjob.h \
+    Communicator/meshloadingjob.h \
+    Communicator/resultcache.h \
     Render/openglwidget.h \
-    Engine/engine.h \
     Render/renderutil.h
 
 DISTFILES +=
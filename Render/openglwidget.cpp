@@ -154,34 +154,46 @@ void OpenGLWidget::renderInterestPointsInBuffer()
  */
 void OpenGLWidget::drawMesh(Mesh * mesh)
 {
-    initializePositions();
+    MeshGeometry geometry;
+    prepareMesh(mesh, geometry);
+    drawGeometry(geometry);
+}
+
+/**
+ * @brief OpenGLWidget::prepareMesh Process the 3D mesh into a drawing buffer.
+ *  It does not use OpenGL, so it can run on any thread.
+ * @param mesh The mesh to be processed.
+ * @param geometry Receives the drawing buffer of the mesh.
+ */
+void OpenGLWidget::prepareMesh(Mesh * mesh, MeshGeometry & geometry)
+{
     QVector3D maxVector(0.0f, 0.0f, 0.0f);
     QVector3D minVector(0.0f, 0.0f, 0.0f);
 
-    vector<Face *> * faces = mesh->getAllFaces();
-    vector<Vertex *> * vertexes = mesh->getAllVertexes();
+    int numFaces = mesh->getNumFaces();
+    const int * triangles = mesh->getTriangles();
+    const double * coordinates = mesh->getCoordinates();
     int coordinatesPerVertex = 3;
 
-    this->vertexes = faces->size() * 3;
+    geometry.vertexes = numFaces * 3;
 
     // Creation of a vector of GLfloats where the coodinates of every vertex in the
     // mesh will be stored, along with the coordinates of its normal vector.
-    data = QVector<GLfloat>(this->vertexes * coordinatesPerVertex * 2);
+    geometry.data = QVector<GLfloat>(geometry.vertexes * coordinatesPerVertex * 2);
 
-    GLfloat * start = &data.first();
-    for (int i = 0; i < faces->size(); i++)
+    GLfloat * start = geometry.data.data();
+    for (int i = 0; i < numFaces; i++)
     {
-        Face * face = faces->at(i);
-        int * pointsIndexes = face->getPointsInFace();
+        const int * pointsIndexes = triangles + 3 * i;
         QVector3D faceVer[3];
 
         float x, y, z;
         for (int j = 0; j< 3; j++)
         {
-            Vertex * current = vertexes->at(pointsIndexes[j]);
-            x = current->getCoordinates()[0];
-            y = current->getCoordinates()[1];
-            z = current->getCoordinates()[2];
+            const double * current = coordinates + 3 * pointsIndexes[j];
+            x = current[0];
+            y = current[1];
+            z = current[2];
 
             faceVer[j].setX(x);
             faceVer[j].setY(y);
@@ -200,6 +212,26 @@ void OpenGLWidget::drawMesh(Mesh * mesh)
         addToData(faceVer, normal, start);
     }
 
+    geometry.maxVector = maxVector;
+    geometry.minVector = minVector;
+}
+
+/**
+ * @brief OpenGLWidget::drawGeometry Render a mesh processed by prepareMesh in
+ *  the OpenGL widget.
+ * @param geometry The drawing buffer of the mesh, its data is moved to the
+ *  widget.
+ */
+void OpenGLWidget::drawGeometry(MeshGeometry & geometry)
+{
+    initializePositions();
+    QVector3D & maxVector = geometry.maxVector;
+    QVector3D & minVector = geometry.minVector;
+
+    this->vertexes = geometry.vertexes;
+    data.swap(geometry.data);
+    geometry.data.clear();
+
     depth = calculateDepth(maxVector, minVector);
     cameraPositionX = -(maxVector.x() + minVector.x()) / 2.0f;
     cameraPositionY = -(maxVector.y() + minVector.y()) / 2.0f;
@@ -220,19 +252,19 @@ void OpenGLWidget::drawMesh(Mesh * mesh)
  *  per interest point, and add it into the drawing buffer.
  * @param interestPoints pointer to the calculated interest points.
  */
-void OpenGLWidget::reallocateBufferWithInteresPoints(vector<Vertex *> * interestPoints)
+void OpenGLWidget::reallocateBufferWithInteresPoints(vector<Vertex> * interestPoints)
 {
 
     this->interestPoints = interestPoints->size();
     QVector<GLfloat> newData = data;
-    for (Vertex * myVertex : *interestPoints)
+    for (Vertex & myVertex : *interestPoints)
     {
         int elements = 0;
 
         QVector3D centre(
-            myVertex->getCoordinates()[0],
-            myVertex->getCoordinates()[1],
-            myVertex->getCoordinates()[2]);
+            myVertex.getCoordinates()[0],
+            myVertex.getCoordinates()[1],
+            myVertex.getCoordinates()[2]);
         GLfloat * elms =
             RenderUtil::generateSphere(
                 proportion * 2.0f,
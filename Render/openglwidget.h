@@ -17,6 +17,19 @@
 #include <QWheelEvent>
 #include <QKeyEvent>
 
+/**
+ * @brief The MeshGeometry struct holds the drawing buffer of a mesh and its
+ *  bounding box. It is built without OpenGL, so it can be prepared on any
+ *  thread and then drawn by the widget.
+ */
+struct MeshGeometry
+{
+    QVector<GLfloat> data;
+    int vertexes;
+    QVector3D maxVector;
+    QVector3D minVector;
+};
+
 /**
  * @brief The OpenGLWidget class represents a widget which renders a 3D Mesh
  *  structure.
@@ -52,7 +65,7 @@ private:
      * vectors), to a vector of QLfloats, by using a pointer to GLfloat as an
      * iterator.
      */
-    void addToData(QVector3D *, QVector3D, GLfloat * &);
+    static void addToData(QVector3D *, QVector3D, GLfloat * &);
 
     /**
      * @brief calculateDepth calculates the right z displacement of the camara,
@@ -132,12 +145,28 @@ public:
      */
     void drawMesh(Mesh * mesh);
 
+    /**
+     * @brief prepareMesh Process the 3D mesh into a drawing buffer. It does
+     *  not use OpenGL, so it can run on any thread.
+     * @param mesh The mesh to be processed.
+     * @param geometry Receives the drawing buffer of the mesh.
+     */
+    static void prepareMesh(Mesh * mesh, MeshGeometry & geometry);
+
+    /**
+     * @brief drawGeometry Render a mesh processed by prepareMesh in the
+     *  OpenGL widget.
+     * @param geometry The drawing buffer of the mesh, its data is moved
+     *  to the widget.
+     */
+    void drawGeometry(MeshGeometry & geometry);
+
     /**
      * @brief reallocateBufferWithInteresPoints create single spheres per
      *  interest point, and add it into the drawing buffer.
      * @param interestPoints pointer to the calculated interest points.
      */
-    void reallocateBufferWithInteresPoints(vector<Vertex *> * interestPoints);
+    void reallocateBufferWithInteresPoints(vector<Vertex> * interestPoints);
 };
 
 #endif
@@ -30,6 +30,10 @@ MainWindow::MainWindow(Communicator * communicator, QWidget * parent) : QMainWin
     file2 = new QString();
 
     this->communicator = communicator;
+    job = NULL;
+    meshJob = NULL;
+    meshGeometry = NULL;
+    meshDrawn = false;
 }
 
 /**
@@ -39,6 +43,8 @@ MainWindow::MainWindow(Communicator * communicator, QWidget * parent) : QMainWin
 void MainWindow::initializeLoadFilesPanel()
 {
     off = new QRadioButton(".off");
+    ply = new QRadioButton(".ply");
+    stl = new QRadioButton(".stl");
     triVert = new QRadioButton(".tri .vert");
     triVert->setChecked(true);
 
@@ -47,6 +53,8 @@ void MainWindow::initializeLoadFilesPanel()
     QButtonGroup * group = new QButtonGroup();
     group->addButton(off, 0);
     group->addButton(triVert, 1);
+    group->addButton(ply, 2);
+    group->addButton(stl, 3);
 
     labelFile1 = new QLabel("Tri");
     labelFile2 = new QLabel("Vert");
@@ -59,9 +67,14 @@ void MainWindow::initializeLoadFilesPanel()
     path2 = new QLineEdit();
     path2->setReadOnly(true);
 
+    QHBoxLayout * typesLayout = new QHBoxLayout();
+    typesLayout->addWidget(off);
+    typesLayout->addWidget(triVert);
+    typesLayout->addWidget(ply);
+    typesLayout->addWidget(stl);
+
     QGridLayout * gridLayout = new QGridLayout();
-    gridLayout->addWidget(off, 0,0);
-    gridLayout->addWidget(triVert, 0, 1);
+    gridLayout->addLayout(typesLayout, 0, 0, 1, 3);
     gridLayout->addWidget(labelFile1, 1, 0);
     gridLayout->addWidget(path1, 1, 1);
     gridLayout->addWidget(openFile1, 1, 2);
@@ -72,6 +85,18 @@ void MainWindow::initializeLoadFilesPanel()
     loadMeshButton = new QPushButton(QString("Load Mesh"));
     gridLayout->addWidget(loadMeshButton, 3, 0, 1, 3);
 
+    // Progress of the loading, only visible while it runs.
+    loadProgressBar = new QProgressBar();
+    loadProgressBar->setRange(0, 100);
+    cancelLoadButton = new QPushButton(QString("Cancel"));
+    gridLayout->addWidget(loadProgressBar, 4, 0, 1, 2);
+    gridLayout->addWidget(cancelLoadButton, 4, 2);
+    loadProgressBar->hide();
+    cancelLoadButton->hide();
+
+    meshTimer = new QTimer(this);
+    meshTimer->setInterval(100);
+
     loadFilesPanel = new QGroupBox();
     loadFilesPanel->setLayout(gridLayout);
     loadFilesPanel->setTitle(QString("Load files"));
@@ -91,6 +116,14 @@ void MainWindow::initializeLoadFilesPanel()
         this, [=](){ this->loadFile(openFile2); });
 
     connect(loadMeshButton, &QPushButton::clicked,this, &MainWindow::loadMesh);
+
+    connect(
+        cancelLoadButton, &QPushButton::clicked,
+        this, &MainWindow::cancelLoadMesh);
+
+    connect(
+        meshTimer, &QTimer::timeout,
+        this, &MainWindow::updateMeshJob);
 }
 
 /**
@@ -134,13 +167,35 @@ void MainWindow::initializePropertiesPanel()
         new QPushButton(QString("Calculate interest points"));
     layout->addRow(calculateInterestPoints);
 
+    // Progress of the calculation, only visible while it runs.
+    progressBar = new QProgressBar();
+    progressBar->setRange(0, 100);
+    cancelButton = new QPushButton(QString("Cancel"));
+    QHBoxLayout * progressLayout = new QHBoxLayout();
+    progressLayout->addWidget(progressBar);
+    progressLayout->addWidget(cancelButton);
+    layout->addRow(progressLayout);
+    progressBar->hide();
+    cancelButton->hide();
+
     propertiesPanel->setLayout(layout);
 
+    jobTimer = new QTimer(this);
+    jobTimer->setInterval(100);
+
     connect(
         calculateInterestPoints,
         &QPushButton::clicked,
         this,
         &MainWindow::loadInterestPoints);
+
+    connect(
+        cancelButton, &QPushButton::clicked,
+        this, &MainWindow::cancelInterestPoints);
+
+    connect(
+        jobTimer, &QTimer::timeout,
+        this, &MainWindow::updateInterestPointsJob);
 }
 
 /**
@@ -159,6 +214,24 @@ void MainWindow::updateFilesPanel(QAbstractButton * button)
         path2->hide();
         meshType = MeshType::OFF;
     }
+    else if (button == ply)
+    {
+        labelFile1->setText(QString("Ply"));
+        path1->clear();
+        labelFile2->hide();
+        openFile2->hide();
+        path2->hide();
+        meshType = MeshType::PLY;
+    }
+    else if (button == stl)
+    {
+        labelFile1->setText(QString("Stl"));
+        path1->clear();
+        labelFile2->hide();
+        openFile2->hide();
+        path2->hide();
+        meshType = MeshType::STL;
+    }
     else if (button == triVert)
     {
         labelFile1->setText(QString("Tri"));
@@ -178,6 +251,8 @@ void MainWindow::updateFilesPanel(QAbstractButton * button)
 void MainWindow::loadFile(QAbstractButton * origin)
 {
     bool isOff = (off->isChecked());
+    bool isPly = (ply->isChecked());
+    bool isStl = (stl->isChecked());
     QString title;
     QString filter;
     QLineEdit * lineEdit = 0;
@@ -185,8 +260,12 @@ void MainWindow::loadFile(QAbstractButton * origin)
 
     if (origin == openFile1)
     {
-        title = QString((isOff)? "Choose an OFF file" : "Choose a .tri file");
-        filter = QString((isOff)? "OFF (*.off)" : "TRI (*.tri)");
+        title = QString((isOff)? "Choose an OFF file"
+            : (isPly)? "Choose a PLY file"
+            : (isStl)? "Choose an STL file" : "Choose a .tri file");
+        filter = QString((isOff)? "OFF (*.off *.off.gz)"
+            : (isPly)? "PLY (*.ply)"
+            : (isStl)? "STL (*.stl)" : "TRI (*.tri *.tri.gz)");
         lineEdit = path1;
         filePath = &file1;
 
@@ -194,7 +273,7 @@ void MainWindow::loadFile(QAbstractButton * origin)
     else if (origin == openFile2)
     {
         title = QString("Choose a .vert file");
-        filter = QString("VERT (*.vert)");
+        filter = QString("VERT (*.vert *.vert.gz)");
         lineEdit = path2;
         filePath = &file2;
     }
@@ -242,21 +321,95 @@ void MainWindow::loadMesh()
         QMessageBox::warning(this, QString("Warning"), message);
         return;
     }
+    if (meshJob != NULL || job != NULL)
+    {
+        return;
+    }
+
+    // The files are read on their own thread, which also prepares the
+    // drawing buffer as soon as they are read, so the mesh is rendered
+    // while the Communicator completes it.
+    meshGeometry = new MeshGeometry();
+    meshDrawn = false;
+    MeshGeometry * geometry = meshGeometry;
+    meshJob =
+        communicator->startLoadMesh(
+            meshType, *file1, *file2,
+            [geometry](Mesh * mesh){ OpenGLWidget::prepareMesh(mesh, *geometry); });
+    setBusy(true, loadProgressBar, cancelLoadButton);
+    meshTimer->start();
+}
+
+/**
+ * @brief MainWindow::updateMeshJob shows the progress of the running loading
+ *  of a mesh and renders the mesh as soon as it has been read.
+ */
+void MainWindow::updateMeshJob()
+{
+    if (meshJob == NULL)
+    {
+        meshTimer->stop();
+        return;
+    }
+
+    // The mesh is marked as read before the job finishes, so reading them
+    // in this order never misses it
+    bool finished = meshJob->isFinished();
+    if (!meshDrawn && meshJob->isMeshRead())
+    {
+        // The rest of the loading can not be cancelled and has no progress
+        render->drawGeometry(*meshGeometry);
+        meshDrawn = true;
+        cancelLoadButton->setEnabled(false);
+        loadProgressBar->setRange(0, 0);
+    }
+    else if (!meshDrawn)
+    {
+        loadProgressBar->setValue(int(100 * meshJob->getProgress()));
+    }
+    if (!finished)
+    {
+        return;
+    }
+
+    meshTimer->stop();
+    MeshLoadingJob * finishedJob = meshJob;
+    meshJob = NULL;
+    delete meshGeometry;
+    meshGeometry = NULL;
+    loadProgressBar->setRange(0, 100);
+    setBusy(false, loadProgressBar, cancelLoadButton);
     try
     {
-        communicator->loadMesh(meshType, *file1, *file2);
+        finishedJob->wait();
+        delete finishedJob;
     }
     catch (Exception & e)
     {
-        QMessageBox::critical(this, "Error", e.what());
-        return;
+        delete finishedJob;
+        if (e.getType() != ExceptionType::JOB_CANCELLED)
+        {
+            QMessageBox::critical(this, "Error", e.what());
+        }
     }
     catch (exception & e)
     {
+        delete finishedJob;
         QMessageBox::critical(this, "Critical Error", e.what());
-        return;
     }
-    render->drawMesh(communicator->getMesh());
+}
+
+/**
+ * @brief MainWindow::cancelLoadMesh asks the running loading of a mesh to
+ *  stop.
+ */
+void MainWindow::cancelLoadMesh()
+{
+    if (meshJob != NULL)
+    {
+        meshJob->cancel();
+        cancelLoadButton->setEnabled(false);
+    }
 }
 
 /**
@@ -267,7 +420,10 @@ void MainWindow::loadMesh()
 void MainWindow::loadInterestPoints()
 {
     bool conversionOk = false;
-    vector<Vertex *> * intPoints;
+    if (job != NULL || meshJob != NULL)
+    {
+        return;
+    }
     try
     {
         int numRings = rings->text().toInt(&conversionOk);
@@ -278,10 +434,13 @@ void MainWindow::loadInterestPoints()
         validateInput(numRings, k, percentageOfPoints, conversionOk);
         QString selectionMode = this->selectionMode->currentText();
 
-        intPoints =
-            communicator->retrieveInterestPoints(
+        // The calculation runs on its own thread, the timer polls it so that
+        // the window keeps responding and the user can cancel it.
+        job =
+            communicator->startInterestPoints(
                 numRings, k, percentageOfPoints, selectionMode);
-        render->reallocateBufferWithInteresPoints(intPoints);
+        setBusy(true, progressBar, cancelButton);
+        jobTimer->start();
     }
     catch (Exception & e)
     {
@@ -295,6 +454,78 @@ void MainWindow::loadInterestPoints()
     }
 }
 
+/**
+ * @brief MainWindow::updateInterestPointsJob shows the progress of the
+ *  running calculation of interest points and renders them once it finishes.
+ */
+void MainWindow::updateInterestPointsJob()
+{
+    if (job == NULL)
+    {
+        jobTimer->stop();
+        return;
+    }
+    progressBar->setValue(int(100 * job->getProgress()));
+    if (!job->isFinished())
+    {
+        return;
+    }
+
+    jobTimer->stop();
+    InterestPointsJob * finishedJob = job;
+    job = NULL;
+    setBusy(false, progressBar, cancelButton);
+    try
+    {
+        vector<Vertex> * intPoints = finishedJob->takeResult();
+        delete finishedJob;
+        render->reallocateBufferWithInteresPoints(intPoints);
+    }
+    catch (Exception & e)
+    {
+        delete finishedJob;
+        if (e.getType() != ExceptionType::JOB_CANCELLED)
+        {
+            QMessageBox::critical(this, "Error", e.what());
+        }
+    }
+    catch (exception & e)
+    {
+        delete finishedJob;
+        QMessageBox::critical(this, "Critical Error", e.what());
+    }
+}
+
+/**
+ * @brief MainWindow::cancelInterestPoints asks the running calculation of
+ *  interest points to stop.
+ */
+void MainWindow::cancelInterestPoints()
+{
+    if (job != NULL)
+    {
+        job->cancel();
+        cancelButton->setEnabled(false);
+    }
+}
+
+/**
+ * @brief MainWindow::setBusy enables or disables the controls that can not be
+ *  used while a job runs, and shows or hides its progress.
+ * @param busy true while a job runs.
+ * @param progress the progress bar of the job.
+ * @param cancel the button that cancels the job.
+ */
+void MainWindow::setBusy(bool busy, QProgressBar * progress, QPushButton * cancel)
+{
+    loadMeshButton->setEnabled(!busy);
+    calculateInterestPoints->setEnabled(!busy);
+    cancel->setEnabled(busy);
+    progress->setValue(0);
+    progress->setVisible(busy);
+    cancel->setVisible(busy);
+}
+
 /**
  * @brief MainWindow::validateInput Validate the input parameters prior the
  *  interest points calculation.
@@ -12,8 +12,10 @@
 #include <QLineEdit>
 #include <QMessageBox>
 #include <QMainWindow>
+#include <QProgressBar>
 #include <QPushButton>
 #include <QRadioButton>
+#include <QTimer>
 
 #include "Communicator/communicator.h"
 #include "Render/openglwidget.h"
@@ -32,6 +34,8 @@ private:
     QGridLayout * buttonsPanel;
 
     QRadioButton * off;
+    QRadioButton * ply;
+    QRadioButton * stl;
     QRadioButton * triVert;
     QPushButton * openFile1;
     QPushButton * openFile2;
@@ -45,7 +49,18 @@ private:
     QLineEdit * percentageOfPoints;
 
     QPushButton * loadMeshButton;
+    QProgressBar * loadProgressBar;
+    QPushButton * cancelLoadButton;
+    QTimer * meshTimer;
+    MeshLoadingJob * meshJob;
+    MeshGeometry * meshGeometry;
+    bool meshDrawn;
+
     QPushButton * calculateInterestPoints;
+    QProgressBar * progressBar;
+    QPushButton * cancelButton;
+    QTimer * jobTimer;
+    InterestPointsJob * job;
 
     Communicator * communicator;
     OpenGLWidget * render;
@@ -89,6 +104,17 @@ private slots:
      */
     void loadMesh();
 
+    /**
+     * @brief updateMeshJob shows the progress of the running loading of a
+     *  mesh and renders the mesh as soon as it has been read.
+     */
+    void updateMeshJob();
+
+    /**
+     * @brief cancelLoadMesh asks the running loading of a mesh to stop.
+     */
+    void cancelLoadMesh();
+
     /**
      * @brief loadInterestPoints read the parameters defined by the user and
      *  send a request to the communicator to calculate the interest points
@@ -96,6 +122,27 @@ private slots:
      */
     void loadInterestPoints();
 
+    /**
+     * @brief updateInterestPointsJob shows the progress of the running
+     *  calculation of interest points and renders them once it finishes.
+     */
+    void updateInterestPointsJob();
+
+    /**
+     * @brief cancelInterestPoints asks the running calculation of interest
+     *  points to stop.
+     */
+    void cancelInterestPoints();
+
+    /**
+     * @brief setBusy enables or disables the controls that can not be used
+     *  while a job runs, and shows or hides its progress.
+     * @param busy true while a job runs.
+     * @param progress the progress bar of the job.
+     * @param cancel the button that cancels the job.
+     */
+    void setBusy(bool busy, QProgressBar * progress, QPushButton * cancel);
+
     /**
      * @brief validateInput Validate the input parameters prior the interest
      *  points calculation.
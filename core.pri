@@ -0,0 +1,52 @@
+# Sources shared by every target that reads meshes and finds interest points
+# without the GUI: BasicStructures, FileManager and Engine. They only need
+# QtCore. Included by InterestPointsDetector.pro, Benchmark/benchmark.pro and
+# Cli/cli.pro.
+
+INCLUDEPATH += $$PWD
+
+# Compressed meshes: gzip is always read with zlib, zstd only when building
+# with CONFIG+=zstd and libzstd installed
+LIBS += -lz
+zstd {
+    DEFINES += HAVE_ZSTD
+    LIBS += -lzstd
+}
+
+SOURCES += \
+    $$PWD/BasicStructures/adjacency.cpp \
+    $$PWD/BasicStructures/face.cpp \
+    $$PWD/BasicStructures/mesh.cpp \
+    $$PWD/BasicStructures/vertex.cpp \
+    $$PWD/FileManager/compressedstream.cpp \
+    $$PWD/FileManager/filemanager.cpp \
+    $$PWD/FileManager/mappedfile.cpp \
+    $$PWD/FileManager/plyheader.cpp \
+    $$PWD/FileManager/textparser.cpp \
+    $$PWD/FileManager/triangulator.cpp \
+    $$PWD/FileManager/vertexwelder.cpp \
+    $$PWD/Engine/engine.cpp \
+    $$PWD/Engine/jobcontrol.cpp \
+    $$PWD/Engine/ringgatherer.cpp \
+    $$PWD/Engine/spatialgrid.cpp \
+    $$PWD/Engine/stageprofile.cpp
+
+HEADERS += \
+    $$PWD/BasicStructures/adjacency.h \
+    $$PWD/BasicStructures/face.h \
+    $$PWD/BasicStructures/mesh.h \
+    $$PWD/BasicStructures/vertex.h \
+    $$PWD/FileManager/compressedstream.h \
+    $$PWD/FileManager/filemanager.h \
+    $$PWD/FileManager/mappedfile.h \
+    $$PWD/FileManager/meshcache.h \
+    $$PWD/FileManager/plyheader.h \
+    $$PWD/FileManager/textparser.h \
+    $$PWD/FileManager/triangulator.h \
+    $$PWD/FileManager/vertexwelder.h \
+    $$PWD/Engine/engine.h \
+    $$PWD/Engine/jobcontrol.h \
+    $$PWD/Engine/parallel.h \
+    $$PWD/Engine/ringgatherer.h \
+    $$PWD/Engine/spatialgrid.h \
+    $$PWD/Engine/stageprofile.h